@@ -251,8 +251,8 @@ namespace alps {
                     using B::operator();
                     void operator()(T const & val) {
                         using alps::numeric::operator+=;
-                        using alps::numeric::operator*;
                         using alps::numeric::check_size;
+                        using alps::numeric::add_square;
 
                         B::operator()(val);
                         if(B::count() == (1UL << m_ac_sum2.size())) {
@@ -272,7 +272,7 @@ namespace alps {
 
                             // in other words: (B::count() % (1L << i) == 0)
                             if (!(B::count() & ((1ll << i) - 1))) {
-                                m_ac_sum2[i] += m_ac_partial[i] * m_ac_partial[i];
+                                add_square(m_ac_sum2[i], m_ac_partial[i]);
                                 m_ac_sum[i] += m_ac_partial[i];
                                 m_ac_count[i]++;
                                 m_ac_partial[i] = T();
@@ -101,13 +101,12 @@ namespace alps {
 
                     using B::operator();
                     void operator()(T const & val) {
-                        using alps::numeric::operator*;
-                        using alps::numeric::operator+=;
                         using alps::numeric::check_size;
+                        using alps::numeric::add_square;
 
                         B::operator()(val);
                         check_size(m_sum2, val);
-                        m_sum2 += val * val;
+                        add_square(m_sum2, val);
                     }
 
                     template<typename S> void print(S & os, bool terse=false) const {
@@ -107,22 +107,7 @@ namespace alps {
                     }
 
                     void load(hdf5::archive & ar) {
-                        std::vector<std::string> list = ar.list_children("");
-                        for (std::vector<std::string>::const_iterator it = list.begin(); it != list.end(); ++it) {
-                            ar.set_context(*it);
-                            for (typename std::vector<boost::shared_ptr<detail::serializable_type<T> > >::const_iterator jt = m_types.begin()
-                                ; jt != m_types.end()
-                                ; ++jt
-                            )
-                                if ((*jt)->can_load(ar)) {
-                                    operator[](*it) = boost::shared_ptr<T>((*jt)->create(ar));
-                                    break;
-                                }
-                            if (!has(*it))
-                                throw std::logic_error("The Accumulator/Result " + *it + " cannot be unserilized" + ALPS_STACKTRACE);
-                            operator[](*it).load(ar);
-                            ar.set_context("..");
-                        }
+                        ar.visit_children("", child_loader(*this, ar));
                     }
 
                     template<typename A> static void register_serializable_type(bool known = false) {
@@ -162,6 +147,31 @@ namespace alps {
                     void clear() { m_storage.clear(); }
 
                 private:
+                    // loads one child of the current group, called for each child by archive::visit_children()
+                    struct child_loader {
+                        child_loader(wrapper_set & set, hdf5::archive & ar) : set_(set), ar_(ar) {}
+
+                        bool operator()(std::string const & name, hdf5::archive::child_type) {
+                            ar_.set_context(name);
+                            for (typename std::vector<boost::shared_ptr<detail::serializable_type<T> > >::const_iterator jt = m_types.begin()
+                                ; jt != m_types.end()
+                                ; ++jt
+                            )
+                                if ((*jt)->can_load(ar_)) {
+                                    set_[name] = boost::shared_ptr<T>((*jt)->create(ar_));
+                                    break;
+                                }
+                            if (!set_.has(name))
+                                throw std::logic_error("The Accumulator/Result " + name + " cannot be unserilized" + ALPS_STACKTRACE);
+                            set_[name].load(ar_);
+                            ar_.set_context("..");
+                            return true;
+                        }
+
+                        wrapper_set & set_;
+                        hdf5::archive & ar_;
+                    };
+
                     std::map<std::string, boost::shared_ptr<T> > m_storage;
                     static std::vector<boost::shared_ptr<detail::serializable_type<T> > > m_types;
             };
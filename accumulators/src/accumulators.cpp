@@ -7,6 +7,7 @@
 #include <alps/accumulators_.hpp>
 #include <alps/accumulators/accumulator.hpp>
 #include <alps/accumulators/namedaccumulators.hpp>
+#include <alps/utilities/profiling.hpp>
 
 
 namespace alps {
@@ -487,9 +488,11 @@ namespace alps {
 #ifdef ALPS_HAVE_MPI
             // collective_merge
             void virtual_accumulator_wrapper::collective_merge(alps::mpi::communicator const & comm, int root) {
+                ALPS_PROFILE_SCOPE("accumulators.collective_merge");
             	m_ptr->collective_merge(comm, root);
             }
             void virtual_accumulator_wrapper::collective_merge(alps::mpi::communicator const & comm, int root) const {
+                ALPS_PROFILE_SCOPE("accumulators.collective_merge");
             	m_ptr->collective_merge(comm, root);
             }
 #endif
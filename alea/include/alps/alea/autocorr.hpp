@@ -8,6 +8,7 @@
 #include <alps/alea/core.hpp>
 #include <alps/alea/util.hpp>
 #include <alps/alea/variance.hpp>
+#include <alps/alea/internal/util.hpp>
 
 #include <vector>
 
@@ -77,13 +78,13 @@ public:
     /** Add Eigen vector-valued expression to accumulator */
     template <typename Derived>
     autocorr_acc &operator<<(const Eigen::DenseBase<Derived> &o)
-    { return *this << eigen_adapter<T,Derived>(o); }
+    { return add(eigen_adapter<T,Derived>(o)); }
 
     /** Add `std::vector` to accumulator */
-    autocorr_acc &operator<<(const std::vector<T> &o) { return *this << vector_adapter<T>(o); }
+    autocorr_acc &operator<<(const std::vector<T> &o) { return add(vector_adapter<T>(o)); }
 
     /** Add scalar value to accumulator */
-    autocorr_acc &operator<<(T o) { return *this << value_adapter<T>(o); }
+    autocorr_acc &operator<<(T o) { return add(value_adapter<T>(o)); }
 
     /** Returns sample size, i.e., number of accumulated data points */
     size_t count() const { return count_; }
@@ -99,6 +100,22 @@ public:
     const level_acc_type &level(size_t i) const { return level_[i]; }
 
 protected:
+    /** Add source of a known type (see `mean_acc::add()`) */
+    template <typename Source>
+    autocorr_acc &add(const Source &source)
+    {
+        assert(count_ < nextlevel_);
+        internal::check_valid(*this);
+
+        // if we require next level, then do it!
+        if(++count_ == nextlevel_)
+            add_level();
+
+        // now add current element at the bottom and watch it propagate
+        level_[0].add(source);
+        return *this;
+    }
+
     void add_level();
 
     void finalize_to(autocorr_result<T> &result);
@@ -7,6 +7,7 @@
 
 #include <alps/alea/core.hpp>
 #include <alps/alea/computed.hpp>
+#include <alps/alea/internal/util.hpp>
 #include <alps/alea/util.hpp>
 #include <alps/alea/internal/galois.hpp>
 #include <alps/alea/var_strategy.hpp>
@@ -97,13 +98,13 @@ public:
     /** Add Eigen vector-valued expression to accumulator */
     template <typename Derived>
     batch_acc &operator<<(const Eigen::DenseBase<Derived> &o)
-    { return *this << eigen_adapter<T,Derived>(o); }
+    { return add(eigen_adapter<T,Derived>(o)); }
 
     /** Add `std::vector` to accumulator */
-    batch_acc &operator<<(const std::vector<T> &o) { return *this << vector_adapter<T>(o); }
+    batch_acc &operator<<(const std::vector<T> &o) { return add(vector_adapter<T>(o)); }
 
     /** Add scalar value to accumulator */
-    batch_acc &operator<<(T o) { return *this << value_adapter<T>(o); }
+    batch_acc &operator<<(T o) { return add(value_adapter<T>(o)); }
 
     /** Returns sample size, i.e., total number of accumulated data points */
     size_t count() const { return store_->count().sum(); }
@@ -124,6 +125,23 @@ public:
     size_t current_batch_size() const { return base_size_ * cursor_.factor(); }
 
 protected:
+    /** Add source of a known type (see `mean_acc::add()`) */
+    template <typename Source>
+    batch_acc &add(const Source &source)
+    {
+        internal::check_valid(*this);
+
+        // batch is full, move the cursor.
+        // Doing this before the addition ensures no empty batches.
+        if (store_->count()(cursor_.current()) == current_batch_size())
+            next_batch();
+
+        // Since Eigen matrix are column-major, we can just pass the pointer
+        source.add_to(sink<T>(store_->batch().col(cursor_.current()).data(), size()));
+        store_->count()(cursor_.current()) += 1;
+        return *this;
+    }
+
     void next_batch();
 
     void finalize_to(batch_result<T> &result);
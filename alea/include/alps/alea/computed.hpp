@@ -28,8 +28,13 @@ namespace alps { namespace alea {
 
 namespace alps { namespace alea {
 
+/*
+ * The adapters are final: the accumulators add them through templated
+ * overloads, so that `add_to()` is called directly and can be inlined.
+ */
+
 template <typename T>
-class value_adapter
+class value_adapter final
     : public computed<T>
 {
 public:
@@ -54,7 +59,7 @@ private:
 };
 
 template <typename T>
-class vector_adapter
+class vector_adapter final
     : public computed<T>
 {
 public:
@@ -69,8 +74,9 @@ public:
     {
         if (out.size() != in_.size())
             throw size_mismatch();
+        T *out_data = out.data();
         for (size_t i = 0; i != in_.size(); ++i)
-            out.data()[i] += in_[i];
+            out_data[i] += in_[i];
     }
 
     ~vector_adapter() { }
@@ -80,7 +86,7 @@ private:
 };
 
 template <typename T, typename Derived>
-class eigen_adapter
+class eigen_adapter final
     : public computed<T>
 {
 public:
@@ -8,6 +8,7 @@
 #include <alps/alea/core.hpp>
 #include <alps/alea/util.hpp>
 #include <alps/alea/computed.hpp>
+#include <alps/alea/internal/util.hpp>
 
 #include <memory>
 
@@ -104,13 +105,13 @@ public:
     /** Add Eigen vector-valued expression to accumulator */
     template <typename Derived>
     mean_acc &operator<<(const Eigen::DenseBase<Derived> &o)
-    { return *this << eigen_adapter<T,Derived>(o); }
+    { return add(eigen_adapter<T,Derived>(o)); }
 
     /** Add `std::vector` to accumulator */
-    mean_acc &operator<<(const std::vector<T> &o) { return *this << vector_adapter<T>(o); }
+    mean_acc &operator<<(const std::vector<T> &o) { return add(vector_adapter<T>(o)); }
 
     /** Add scalar value to accumulator */
-    mean_acc &operator<<(T o) { return *this << value_adapter<T>(o); }
+    mean_acc &operator<<(T o) { return add(value_adapter<T>(o)); }
 
     /** Returns sample size, i.e., number of accumulated data points */
     size_t count() const { return store_->count(); }
@@ -125,6 +126,19 @@ public:
     const mean_data<T> &store() const { return *store_; }
 
 protected:
+    /**
+     * Add source of a known type: unless `Source` is `computed<T>`,
+     * `Source::add_to()` is called directly rather than through the vtable.
+     */
+    template <typename Source>
+    mean_acc &add(const Source &source)
+    {
+        internal::check_valid(*this);
+        source.add_to(sink<T>(store_->data().data(), size()));
+        store_->count() += 1;
+        return *this;
+    }
+
     void finalize_to(mean_result<T> &result);
 
 private:
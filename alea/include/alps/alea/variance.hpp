@@ -10,6 +10,7 @@
 #include <alps/alea/bundle.hpp>
 #include <alps/alea/complex_op.hpp>
 #include <alps/alea/computed.hpp>
+#include <alps/alea/internal/util.hpp>
 #include <alps/alea/var_strategy.hpp>
 
 #include <memory>
@@ -121,13 +122,13 @@ public:
     /** Add Eigen vector-valued expression to accumulator */
     template <typename Derived>
     var_acc &operator<<(const Eigen::DenseBase<Derived> &o)
-    { return *this << eigen_adapter<T,Derived>(o); }
+    { return add(eigen_adapter<T,Derived>(o)); }
 
     /** Add `std::vector` to accumulator */
-    var_acc &operator<<(const std::vector<T> &o) { return *this << vector_adapter<T>(o); }
+    var_acc &operator<<(const std::vector<T> &o) { return add(vector_adapter<T>(o)); }
 
     /** Add scalar value to accumulator */
-    var_acc &operator<<(T o) { return *this << value_adapter<T>(o); }
+    var_acc &operator<<(T o) { return add(value_adapter<T>(o)); }
 
     /** Returns sample size, i.e., number of accumulated data points */
     size_t count() const { return store_->count(); }
@@ -144,6 +145,19 @@ public:
     const var_data<T,Strategy> &store() const { return *store_; }
 
 protected:
+    /** Add source of a known type (see `mean_acc::add()`) */
+    template <typename Source>
+    var_acc &add(const Source &source)
+    {
+        internal::check_valid(*this);
+        source.add_to(sink<T>(current_.sum().data(), current_.size()));
+        ++current_.count();
+
+        if (current_.is_full())
+            add_bundle();
+        return *this;
+    }
+
     void add_bundle();
 
     void uplevel(var_acc &new_uplevel) { uplevel_ = &new_uplevel; }
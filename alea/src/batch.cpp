@@ -82,18 +82,7 @@ void batch_acc<T>::reset()
 template <typename T>
 batch_acc<T> &batch_acc<T>::operator<<(const computed<T> &source)
 {
-    internal::check_valid(*this);
-
-    // batch is full, move the cursor.
-    // Doing this before the addition ensures no empty batches.
-    if (store_->count()(cursor_.current()) == current_batch_size())
-        next_batch();
-
-    // Since Eigen matrix are column-major, we can just pass the pointer
-    source.add_to(sink<T>(store_->batch().col(cursor_.current()).data(), size()));
-    store_->count()(cursor_.current()) += 1;
-
-    return *this;
+    return add(source);
 }
 
 template <typename T>
@@ -47,10 +47,7 @@ mean_acc<T> &mean_acc<T>::operator=(const mean_acc &other)
 template <typename T>
 mean_acc<T> &mean_acc<T>::operator<<(const computed<T> &source)
 {
-    internal::check_valid(*this);
-    source.add_to(sink<T>(store_->data().data(), size()));
-    store_->count() += 1.0;
-    return *this;
+    return add(source);
 }
 
 template <typename T>
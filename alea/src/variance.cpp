@@ -79,13 +79,7 @@ void var_acc<T,Str>::reset()
 template <typename T, typename Str>
 var_acc<T,Str> &var_acc<T,Str>::operator<<(const computed<value_type> &source)
 {
-    internal::check_valid(*this);
-    source.add_to(sink<T>(current_.sum().data(), current_.size()));
-    ++current_.count();
-
-    if (current_.is_full())
-        add_bundle();
-    return *this;
+    return add(source);
 }
 
 template <typename T, typename Str>
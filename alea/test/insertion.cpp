@@ -0,0 +1,108 @@
+#include <alps/alea/mean.hpp>
+#include <alps/alea/variance.hpp>
+#include <alps/alea/covariance.hpp>
+#include <alps/alea/autocorr.hpp>
+#include <alps/alea/batch.hpp>
+
+#include "gtest/gtest.h"
+#include "dataset.hpp"
+
+/**
+ * User-defined lazy source: the twogauss data point `i`, computed when added
+ */
+class twogauss_source
+    : public alps::alea::computed<double>
+{
+public:
+    twogauss_source(size_t i) : i_(i) { }
+
+    size_t size() const { return 2; }
+
+    void add_to(alps::alea::sink<double> out) const
+    {
+        if (out.size() != 2)
+            throw alps::alea::size_mismatch();
+        out.data()[0] += twogauss_data[i_][0];
+        out.data()[1] += twogauss_data[i_][1];
+    }
+
+private:
+    size_t i_;
+};
+
+template <typename Acc>
+class insertion_case
+    : public ::testing::Test
+{
+public:
+    /** Adds all data points through the virtual interface */
+    void fill_computed(Acc &acc)
+    {
+        for (size_t i = 0; i != twogauss_count; ++i)
+            acc << twogauss_source(i);
+    }
+
+    void fill_vector(Acc &acc)
+    {
+        std::vector<double> curr(2);
+        for (size_t i = 0; i != twogauss_count; ++i) {
+            std::copy(twogauss_data[i], twogauss_data[i+1], curr.begin());
+            acc << curr;
+        }
+    }
+
+    void fill_eigen(Acc &acc)
+    {
+        for (size_t i = 0; i != twogauss_count; ++i)
+            acc << Eigen::Map<const Eigen::Vector2d>(twogauss_data[i]);
+    }
+
+    void fill_scalar(Acc &acc, size_t component)
+    {
+        for (size_t i = 0; i != twogauss_count; ++i)
+            acc << twogauss_data[i][component];
+    }
+
+    void test_paths()
+    {
+        Acc acc_computed(2), acc_vector(2), acc_eigen(2), acc_scalar(1);
+        fill_computed(acc_computed);
+        fill_vector(acc_vector);
+        fill_eigen(acc_eigen);
+        fill_scalar(acc_scalar, 1);
+
+        const alps::alea::column<double> expected = acc_computed.result().mean();
+        EXPECT_EQ(twogauss_count, acc_computed.count());
+        EXPECT_EQ(twogauss_count, acc_scalar.count());
+        for (size_t i = 0; i != 2; ++i) {
+            EXPECT_NEAR(twogauss_mean[i], expected(i), 1e-6);
+            EXPECT_EQ(expected(i), acc_vector.result().mean()(i));
+            EXPECT_EQ(expected(i), acc_eigen.result().mean()(i));
+        }
+        EXPECT_EQ(expected(1), acc_scalar.result().mean()(0));
+    }
+
+    void test_size_mismatch()
+    {
+        Acc acc(2);
+        EXPECT_THROW(acc << 1.0, alps::alea::size_mismatch);
+        EXPECT_THROW(acc << std::vector<double>(3), alps::alea::size_mismatch);
+        EXPECT_THROW(acc << Eigen::Vector3d::Zero(), alps::alea::size_mismatch);
+
+        Acc acc_scalar(1);
+        EXPECT_THROW(acc_scalar << twogauss_source(0), alps::alea::size_mismatch);
+    }
+};
+
+typedef ::testing::Types<
+    alps::alea::mean_acc<double>,
+    alps::alea::var_acc<double>,
+    alps::alea::cov_acc<double>,
+    alps::alea::autocorr_acc<double>,
+    alps::alea::batch_acc<double>
+    > insertion_types;
+
+TYPED_TEST_CASE(insertion_case, insertion_types);
+
+TYPED_TEST(insertion_case, test_paths) { this->test_paths(); }
+TYPED_TEST(insertion_case, test_size_mismatch) { this->test_size_mismatch(); }
@@ -94,6 +94,7 @@ else()
   message(FATAL_ERROR "ALPS_BUILD_TYPE should be set to either 'static' or 'dynamic' (or 'unspecified' only if you know what your are doing)")
 endif()
 option(ALPS_BUILD_PIC "Generate position-independent code (PIC)" OFF)
+option(ALPS_ENABLE_PROFILING "Instrument ALPSCore with scoped timers (see alps/utilities/profiling.hpp)" OFF)
 
 # Set ALPS_ROOT as a hint for standalone component builds
 if (DEFINED ENV{ALPS_ROOT})
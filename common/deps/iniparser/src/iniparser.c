@@ -10,6 +10,7 @@
 /*---------------------------- Includes ------------------------------------*/
 #include <ctype.h>
 #include <stdarg.h>
+#include <limits.h>
 #include "iniparser.h"
 
 /*---------------------------- Defines -------------------------------------*/
@@ -700,70 +701,115 @@ static line_status iniparser_line(
     return sta ;
 }
 
-/*-------------------------------------------------------------------------*/
-/**
-  @brief    Parse an ini file and return an allocated dictionary object
-  @param    ininame Name of the ini file to read.
-  @return   Pointer to newly allocated dictionary
+/* Source of the lines parsed by iniparser_load_source(): an open file or a string */
+typedef struct _ini_source_ {
+    FILE * file ;
+    const char * str ;
+} ini_source ;
 
-  This is the parser for ini files. This function is called, providing
-  the name of the file to be read. It returns a dictionary object that
-  should not be accessed directly, but through accessor functions
-  instead.
+/* Reads a line like fgets() from the file or the string of the source */
+static char * ini_source_gets(char * buf, int size, ini_source * src)
+{
+    int n = 0 ;
 
-  The returned dictionary must be freed using iniparser_freedict().
- */
-/*--------------------------------------------------------------------------*/
-dictionary * iniparser_load(const char * ininame)
+    if (src->file)
+        return fgets(buf, size, src->file) ;
+    if (*src->str==0)
+        return NULL ;
+    while (n<size-1 && src->str[n]!=0) {
+        buf[n] = src->str[n] ;
+        if (src->str[n++]=='\n')
+            break ;
+    }
+    buf[n] = 0 ;
+    src->str += n ;
+    return buf ;
+}
+
+/* Reads a whole line (including the '\n', if any) from the source and
+   stores it at `offset` in the buffer, growing the buffer as needed.
+   Returns the number of characters read: 0 at the end of the input,
+   -1 on memory allocation failure. */
+static long ini_source_getline(ini_source * src, char ** buf, size_t * size, size_t offset)
 {
-    FILE * in ;
+    size_t len = offset ;
+    size_t chunk ;
+    char * grown ;
+
+    for (;;) {
+        if (*size-len < 2) {
+            grown = (char *)realloc(*buf, *size ? 2*(*size) : ASCIILINESZ+1) ;
+            if (grown==NULL)
+                return -1 ;
+            *size = *size ? 2*(*size) : ASCIILINESZ+1 ;
+            *buf = grown ;
+        }
+        chunk = *size-len ;
+        if (chunk>INT_MAX)
+            chunk = INT_MAX ;
+        if (ini_source_gets(*buf+len, (int)chunk, src)==NULL)
+            break ;
+        len += strlen(*buf+len) ;
+        if (len>offset && (*buf)[len-1]=='\n')
+            break ;
+    }
+    (*buf)[len] = 0 ;
+    return (long)(len-offset) ;
+}
 
-    char line    [ASCIILINESZ+1] ;
-    char section [ASCIILINESZ+1] ;
-    char key     [ASCIILINESZ+1] ;
-    char tmp     [(ASCIILINESZ * 2) + 1] ;
-    char val     [ASCIILINESZ+1] ;
+/* Makes sure that `*buf` can hold `size` characters, keeping its content */
+static int ini_reserve(char ** buf, size_t size)
+{
+    char * grown = (char *)realloc(*buf, size) ;
+    if (grown==NULL)
+        return -1 ;
+    *buf = grown ;
+    return 0 ;
+}
 
-    int  last=0 ;
-    int  len ;
+/* Parses the lines of the source, see iniparser_load() */
+static dictionary * iniparser_load_source(ini_source * src, const char * ininame)
+{
+    /* Lines may be arbitrarily long: all buffers grow with the longest line */
+    char * line = NULL ;
+    char * section = NULL ;
+    char * key = NULL ;
+    char * tmp = NULL ;
+    char * val = NULL ;
+    size_t line_size = 0 ;
+    size_t buf_size = 0 ;
+
+    size_t last=0 ;
+    long nread ;
+    long len ;
     int  lineno=0 ;
     int  errs=0;
     int  mem_err=0;
 
     dictionary * dict ;
 
-    if ((in=fopen(ininame, "r"))==NULL) {
-        iniparser_error_callback("iniparser: cannot open %s\n", ininame);
-        return NULL ;
-    }
-
     dict = dictionary_new(0) ;
     if (!dict) {
-        fclose(in);
         return NULL ;
     }
 
-    memset(line,    0, ASCIILINESZ);
-    memset(section, 0, ASCIILINESZ);
-    memset(key,     0, ASCIILINESZ);
-    memset(val,     0, ASCIILINESZ);
-    last=0 ;
-
-    while (fgets(line+last, ASCIILINESZ-last, in)!=NULL) {
+    while ((nread=ini_source_getline(src, &line, &line_size, last))>0) {
         lineno++ ;
-        len = (int)strlen(line)-1;
+        if (line_size>buf_size) {
+            if (ini_reserve(&section, line_size)
+                || ini_reserve(&key, line_size)
+                || ini_reserve(&val, line_size)
+                || ini_reserve(&tmp, 2*line_size+1)) {
+                mem_err = -1 ;
+                break ;
+            }
+            if (buf_size==0)
+                section[0] = 0 ;
+            buf_size = line_size ;
+        }
+        len = (long)(last+nread)-1;
         if (len<=0)
             continue;
-        /* Safety check against buffer overflows */
-        if (line[len]!='\n' && !feof(in)) {
-            iniparser_error_callback(
-              "iniparser: input line too long in %s (%d)\n",
-              ininame,
-              lineno);
-            dictionary_del(dict);
-            fclose(in);
-            return NULL ;
-        }
         /* Get rid of \n and spaces at end of line */
         while ((len>=0) &&
                 ((line[len]=='\n') || (isspace(line[len])))) {
@@ -807,21 +853,80 @@ dictionary * iniparser_load(const char * ininame)
             default:
             break ;
         }
-        memset(line, 0, ASCIILINESZ);
         last=0;
         if (mem_err<0) {
-            iniparser_error_callback("iniparser: memory allocation failure\n");
             break ;
         }
     }
+    if (nread<0 || mem_err<0) {
+        iniparser_error_callback("iniparser: memory allocation failure\n");
+        errs++ ;
+    }
+    free(line) ;
+    free(section) ;
+    free(key) ;
+    free(tmp) ;
+    free(val) ;
     if (errs) {
         dictionary_del(dict);
         dict = NULL ;
     }
+    return dict ;
+}
+
+/*-------------------------------------------------------------------------*/
+/**
+  @brief    Parse an ini file and return an allocated dictionary object
+  @param    ininame Name of the ini file to read.
+  @return   Pointer to newly allocated dictionary
+
+  This is the parser for ini files. This function is called, providing
+  the name of the file to be read. It returns a dictionary object that
+  should not be accessed directly, but through accessor functions
+  instead.
+
+  The returned dictionary must be freed using iniparser_freedict().
+ */
+/*--------------------------------------------------------------------------*/
+dictionary * iniparser_load(const char * ininame)
+{
+    FILE * in ;
+    ini_source src ;
+    dictionary * dict ;
+
+    if ((in=fopen(ininame, "r"))==NULL) {
+        iniparser_error_callback("iniparser: cannot open %s\n", ininame);
+        return NULL ;
+    }
+    src.file = in ;
+    src.str = NULL ;
+    dict = iniparser_load_source(&src, ininame) ;
     fclose(in);
     return dict ;
 }
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief    Parse ini-formatted text and return an allocated dictionary object
+  @param    content Null-terminated text in ini format.
+  @param    ininame Name of the text used in error messages.
+  @return   Pointer to newly allocated dictionary
+
+  Same as iniparser_load(), but the lines are taken from memory instead
+  of a file.
+
+  The returned dictionary must be freed using iniparser_freedict().
+ */
+/*--------------------------------------------------------------------------*/
+dictionary * iniparser_load_string(const char * content, const char * ininame)
+{
+    ini_source src ;
+
+    src.file = NULL ;
+    src.str = content ;
+    return iniparser_load_source(&src, ininame) ;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief    Free all memory associated to an ini dictionary
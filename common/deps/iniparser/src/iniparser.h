@@ -338,6 +338,21 @@ int iniparser_find_entry(const dictionary * ini, const char * entry) ;
 /*--------------------------------------------------------------------------*/
 dictionary * iniparser_load(const char * ininame);
 
+/*-------------------------------------------------------------------------*/
+/**
+  @brief    Parse ini-formatted text and return an allocated dictionary object
+  @param    content Null-terminated text in ini format.
+  @param    ininame Name of the text used in error messages.
+  @return   Pointer to newly allocated dictionary
+
+  Same as iniparser_load(), but the lines are taken from memory instead
+  of a file.
+
+  The returned dictionary must be freed using iniparser_freedict().
+ */
+/*--------------------------------------------------------------------------*/
+dictionary * iniparser_load_string(const char * content, const char * ininame);
+
 /*-------------------------------------------------------------------------*/
 /**
   @brief    Free all memory associated to an ini dictionary
@@ -5,6 +5,7 @@
  */
 #pragma once
 #include "tail.hpp"
+#include <alps/utilities/profiling.hpp>
 
 namespace alps {
 namespace gf {
@@ -21,6 +22,7 @@ inline double f_tau(double tau, double beta, double c1, double c2, double c3) {
 
 ///Fourier transform kernel of the omega -> tau transform
 inline void transform_vector_no_tail(const std::vector<std::complex<double> >&input_data, const std::vector<double> &omega, std::vector<double> &output_data, const std::vector<double> &tau, double beta){
+  ALPS_PROFILE_SCOPE("gf.fourier");
   for (unsigned int i=0; i<output_data.size(); ++i) {
     output_data[i] = 0.;
     for (unsigned int k=0; k<input_data.size(); ++k) {
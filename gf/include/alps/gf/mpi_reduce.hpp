@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_reduce.hpp
+    @brief Functions to MPI-reduce internal data structures
+ */
+
+#ifndef ALPS_GF_MPI_REDUCE_HPP_5b0e8d2c47a94f61a3c9e7f1d2b48a06
+#define ALPS_GF_MPI_REDUCE_HPP_5b0e8d2c47a94f61a3c9e7f1d2b48a06
+
+#include <alps/utilities/mpi.hpp>
+#include <alps/utilities/mpi_hierarchical.hpp>
+
+#include <boost/multi_array.hpp>
+
+#include <functional>
+#include <stdexcept>
+
+namespace alps {
+    namespace gf {
+        namespace detail {
+            /// Sum a multi-array over the processes, in place on the root
+            /**
+               The arrays must have the same shape on all processes; the
+               reduction is node-aware (see `alps::mpi::node_aware_reduce()`).
+
+               @note Only a particular (namely, C) storage order is supported.
+             */
+            template <typename T, size_t N>
+            void reduce(const alps::mpi::communicator& comm, boost::multi_array<T,N>& data, int root)
+            {
+                if (! (data.storage_order()==boost::c_storage_order()) )
+                    throw std::logic_error("Unsupported storage order in multi_array reduce");
+                if (data.num_elements()==0) return;
+                alps::mpi::node_aware_reduce(comm, data.data(), data.num_elements(), data.data(),
+                                             std::plus<T>(), root);
+            }
+        } // detail::
+    } // gf::
+} // alps::
+
+#endif /* ALPS_GF_MPI_REDUCE_HPP_5b0e8d2c47a94f61a3c9e7f1d2b48a06 */
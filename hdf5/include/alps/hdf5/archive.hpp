@@ -65,6 +65,35 @@ namespace alps {
 #undef ALPS_HDF5_IS_NATIVE_TYPE_CALLER
 
 
+        /// Selection of entries along one dimension of a dataset, see `archive_proxy::slice()`
+        class range {
+            public:
+                /// Selects all entries
+                range()
+                    : start_(0), stop_(std::size_t(-1)), stride_(1), index_(false)
+                {}
+
+                /// Selects the single entry `index`; the dimension is dropped from the loaded value
+                explicit range(std::size_t index)
+                    : start_(index), stop_(index + 1), stride_(1), index_(true)
+                {}
+
+                /// Selects the entries `start, start + stride, ...` below `stop`
+                range(std::size_t start, std::size_t stop, std::size_t stride = 1)
+                    : start_(start), stop_(stop), stride_(stride), index_(false)
+                {}
+
+                std::size_t start() const { return start_; }
+                /// Upper bound of the selection, `extent` if all entries up to the end are selected
+                std::size_t stop(std::size_t extent) const { return stop_ == std::size_t(-1) ? extent : stop_; }
+                std::size_t stride() const { return stride_; }
+                bool is_index() const { return index_; }
+
+            private:
+                std::size_t start_, stop_, stride_;
+                bool index_;
+        };
+
         namespace detail {
             struct archivecontext;
 
@@ -84,6 +113,19 @@ namespace alps {
             ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_IS_DATATYPE_CALLER)
             #undef ALPS_HDF5_IS_DATATYPE_CALLER
 
+            template<typename A> struct archive_slice_proxy {
+
+                explicit archive_slice_proxy(std::string const & path, std::vector<range> const & ranges, A & ar)
+                    : path_(path), ranges_(ranges), ar_(ar)
+                {}
+
+                template <typename T> archive_slice_proxy & operator>>(T & value);
+
+                std::string path_;
+                std::vector<range> ranges_;
+                A ar_;
+            };
+
             template<typename A> struct archive_proxy {
 
                 explicit archive_proxy(std::string const & path, A & ar)
@@ -94,6 +136,12 @@ namespace alps {
                 template<typename T> archive_proxy & operator<<(T const & value);
                 template <typename T> archive_proxy & operator>>(T & value);
 
+                /// Restricts loading to a hyperslab of the dataset, e.g. `ar["data"].slice(ranges) >> value`.
+                /// One `range` is given per leading dimension, missing trailing ones select everything.
+                archive_slice_proxy<A> slice(std::vector<range> const & ranges) {
+                    return archive_slice_proxy<A>(path_, ranges, ar_);
+                }
+
                 std::string path_;
                 A ar_;
             };
@@ -125,6 +173,12 @@ namespace alps {
                 virtual ~archive();
                 static void abort();
 
+                /// create `master` as a file of virtual datasets, each concatenating along the first dimension
+                /// the datasets stored under the same path in all `shards` (scalars are stacked into a vector);
+                /// the shards must be closed for writing and their names are stored as given; returns the paths
+                /// that are missing or differ in layout between shards and were therefore left out of the master file
+                static std::vector<std::string> stitch_shards(std::string const & master, std::vector<std::string> const & shards);
+
                 std::string const & get_filename() const;
 
                 std::string encode_segment(std::string segment) const;
@@ -154,6 +208,21 @@ namespace alps {
                 std::vector<std::string> list_children(std::string path) const;
                 std::vector<std::string> list_attributes(std::string path) const;
 
+                /// kind of a group member, passed to the callback of `visit_children()`
+                typedef enum {
+                    GROUP,
+                    DATA,
+                    OTHER
+                } child_type;
+
+                /// calls `bool f(std::string const & name, child_type type)` for each child of the group `path`
+                /// in name order, streaming the children from the file instead of collecting them first;
+                /// the traversal stops as soon as `f` returns false
+                template<typename F> void visit_children(std::string path, F f) const {
+                    children_visitor_impl<F> visitor(f);
+                    visit_children_impl(path, visitor);
+                }
+
                 std::vector<std::size_t> extent(std::string path) const;
                 std::size_t dimensions(std::string path) const;
 
@@ -177,6 +246,7 @@ namespace alps {
                     , T *
                     , std::vector<std::size_t>
                     , std::vector<std::size_t> = std::vector<std::size_t>()
+                    , std::vector<std::size_t> = std::vector<std::size_t>()
                 ) const {
                     throw std::logic_error("Invalid type on path: " + path + ALPS_STACKTRACE);
                 }
@@ -198,6 +268,7 @@ namespace alps {
                         , T * value                                                                                                                                    \
                         , std::vector<std::size_t> chunk                                                                                                               \
                         , std::vector<std::size_t> offset = std::vector<std::size_t>()                                                                                 \
+                        , std::vector<std::size_t> stride = std::vector<std::size_t>()                                                                                 \
                     ) const;                                                                                                                                           \
                                                                                                                                                                        \
                     void write(std::string path, T value) const;                                                                                                       \
@@ -217,6 +288,19 @@ namespace alps {
 
             private:
 
+                struct children_visitor {
+                    virtual ~children_visitor() {}
+                    virtual bool visit(std::string const & name, child_type type) = 0;
+                };
+
+                template<typename F> struct children_visitor_impl : public children_visitor {
+                    explicit children_visitor_impl(F & f) : f_(f) {}
+                    bool visit(std::string const & name, child_type type) { return f_(name, type); }
+                    F & f_;
+                };
+
+                void visit_children_impl(std::string path, children_visitor & visitor) const;
+
                 void construct(std::string const & filename, std::size_t props = READ);
                 std::string file_key(std::string filename, bool memory) const;
 
@@ -308,6 +392,28 @@ namespace alps {
             return detail::is_vectorizable<T>::apply(value);
         }
 
+        namespace detail {
+            /// Translates `ranges` into the `chunk`, `offset` and `stride` of a hyperslab of the dataset at `path`;
+            /// returns the extent of the selection without the dimensions selected by a single index
+            std::vector<std::size_t> resolve_slice(
+                  archive const & ar
+                , std::string const & path
+                , std::vector<range> const & ranges
+                , std::vector<std::size_t> & chunk
+                , std::vector<std::size_t> & offset
+                , std::vector<std::size_t> & stride
+            );
+        }
+
+        template<typename T> void load_slice(
+               archive & /*ar*/
+             , std::string const & path
+             , T & /*value*/
+             , std::vector<range> const & /*ranges*/
+        ) {
+            throw std::logic_error("slices can only be loaded into containers of continuous types: " + path + ALPS_STACKTRACE);
+        }
+
         template<typename T> void save(
                archive & ar
              , std::string const & path
@@ -461,6 +567,11 @@ namespace alps {
                 return *this;
             }
 
+            template<typename A> template <typename T> archive_slice_proxy<A> & archive_slice_proxy<A>::operator>> (T & value) {
+                load_slice(ar_, path_, value, ranges_);
+                return *this;
+            }
+
         }
     }
 }
@@ -23,5 +23,10 @@
     #define ALPS_HDF5_SZIP_BLOCK_SIZE 32
 #endif
 
+// upper bound of the chunk size in bytes of compressed datasets. Default: 256 KiB
+#ifndef ALPS_HDF5_SZIP_CHUNK_SIZE
+    #define ALPS_HDF5_SZIP_CHUNK_SIZE (1ULL<<18)
+#endif
+
 #endif
 
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file eigen.hpp
+    @brief HDF5 adaptors for `Eigen::Matrix`, `Eigen::Array` and `Eigen::Map`
+
+    Matrices are stored as row-major (C order) datasets of shape `rows x cols`,
+    which is the layout seen by `boost::multi_array` and numpy; objects that are
+    vectors at compile time are stored as one-dimensional datasets, so that they
+    are interchangeable with `std::vector`. Complex scalars add a trailing
+    dimension of size 2, as for `std::complex`.
+
+    Row-major objects and objects with a single row or column are read and written
+    in place; only column-major matrices with more than one row and column are
+    transposed through a temporary. Loading into an `Eigen::Map` writes into the
+    mapped memory, which must already have the dimensions of the dataset.
+*/
+
+#ifndef ALPS_HDF5_EIGEN_HPP
+#define ALPS_HDF5_EIGEN_HPP
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/complex.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+namespace alps {
+    namespace hdf5 {
+
+        template<typename S, int R, int C, int O, int MR, int MC> struct scalar_type<Eigen::Matrix<S, R, C, O, MR, MC> > {
+            typedef typename scalar_type<S>::type type;
+        };
+        template<typename S, int R, int C, int O, int MR, int MC> struct scalar_type<Eigen::Array<S, R, C, O, MR, MC> > {
+            typedef typename scalar_type<S>::type type;
+        };
+        template<typename P, int M, typename St> struct scalar_type<Eigen::Map<P, M, St> > {
+            typedef typename scalar_type<typename alps::detail::remove_cvr<typename P::Scalar>::type>::type type;
+        };
+
+        template<typename S, int R, int C, int O, int MR, int MC> struct has_complex_elements<Eigen::Matrix<S, R, C, O, MR, MC> >
+            : public has_complex_elements<typename alps::detail::remove_cvr<S>::type>
+        {};
+        template<typename S, int R, int C, int O, int MR, int MC> struct has_complex_elements<Eigen::Array<S, R, C, O, MR, MC> >
+            : public has_complex_elements<typename alps::detail::remove_cvr<S>::type>
+        {};
+        template<typename P, int M, typename St> struct has_complex_elements<Eigen::Map<P, M, St> >
+            : public has_complex_elements<typename alps::detail::remove_cvr<typename P::Scalar>::type>
+        {};
+
+        namespace detail {
+
+            /// Logical shape of an Eigen object: `{size}` for compile-time vectors, `{rows, cols}` otherwise
+            template<typename D> std::vector<std::size_t> eigen_shape(Eigen::DenseBase<D> const & value) {
+                std::vector<std::size_t> result;
+                if (D::IsVectorAtCompileTime)
+                    result.push_back(value.size());
+                else {
+                    result.push_back(value.rows());
+                    result.push_back(value.cols());
+                }
+                return result;
+            }
+
+            /// True if the memory of `value` is laid out as the row-major dataset it is stored as
+            template<typename D> bool eigen_is_row_contiguous(Eigen::DenseBase<D> const & value) {
+                return value.innerStride() == 1
+                    && (value.outerStride() == value.innerSize() || value.outerSize() == 1)
+                    && (D::IsRowMajor || value.rows() == 1 || value.cols() == 1);
+            }
+
+            template<typename D> struct eigen_get_extent {
+                static std::vector<std::size_t> apply(D const & value) {
+                    using alps::hdf5::get_extent;
+                    std::vector<std::size_t> result(eigen_shape(value));
+                    std::vector<std::size_t> extent(get_extent(typename D::Scalar()));
+                    std::copy(extent.begin(), extent.end(), std::back_inserter(result));
+                    return result;
+                }
+            };
+
+            template<typename D> struct eigen_set_extent {
+                static void apply(D & value, std::vector<std::size_t> const & size) {
+                    std::size_t const rank = D::IsVectorAtCompileTime ? 1 : 2;
+                    if (size.size() < rank)
+                        throw archive_error("invalid data size" + ALPS_STACKTRACE);
+                    Eigen::Index rows = D::IsVectorAtCompileTime ? (D::RowsAtCompileTime == 1 ? 1 : size[0]) : size[0];
+                    Eigen::Index cols = D::IsVectorAtCompileTime ? (D::RowsAtCompileTime == 1 ? size[0] : 1) : size[1];
+                    if (   (D::RowsAtCompileTime != Eigen::Dynamic && D::RowsAtCompileTime != rows)
+                        || (D::ColsAtCompileTime != Eigen::Dynamic && D::ColsAtCompileTime != cols)
+                    )
+                        throw archive_error("dimensions do not match" + ALPS_STACKTRACE);
+                    value.resize(rows, cols);
+                }
+            };
+
+            template<typename D> struct eigen_is_vectorizable {
+                static bool apply(D const & /*value*/) {
+                    return true;
+                }
+            };
+
+            template<typename S, int R, int C, int O, int MR, int MC> struct get_extent<Eigen::Matrix<S, R, C, O, MR, MC> >
+                : public eigen_get_extent<Eigen::Matrix<S, R, C, O, MR, MC> >
+            {};
+            template<typename S, int R, int C, int O, int MR, int MC> struct get_extent<Eigen::Array<S, R, C, O, MR, MC> >
+                : public eigen_get_extent<Eigen::Array<S, R, C, O, MR, MC> >
+            {};
+            template<typename P, int M, typename St> struct get_extent<Eigen::Map<P, M, St> >
+                : public eigen_get_extent<Eigen::Map<P, M, St> >
+            {};
+
+            template<typename S, int R, int C, int O, int MR, int MC> struct set_extent<Eigen::Matrix<S, R, C, O, MR, MC> >
+                : public eigen_set_extent<Eigen::Matrix<S, R, C, O, MR, MC> >
+            {};
+            template<typename S, int R, int C, int O, int MR, int MC> struct set_extent<Eigen::Array<S, R, C, O, MR, MC> >
+                : public eigen_set_extent<Eigen::Array<S, R, C, O, MR, MC> >
+            {};
+            template<typename P, int M, typename St> struct set_extent<Eigen::Map<P, M, St> > {
+                static void apply(Eigen::Map<P, M, St> & value, std::vector<std::size_t> const & size) {
+                    std::vector<std::size_t> shape(eigen_shape(value));
+                    if (size.size() < shape.size() || !std::equal(shape.begin(), shape.end(), size.begin()))
+                        throw archive_error("dimensions of the mapped memory do not match" + ALPS_STACKTRACE);
+                }
+            };
+
+            template<typename S, int R, int C, int O, int MR, int MC> struct is_vectorizable<Eigen::Matrix<S, R, C, O, MR, MC> >
+                : public eigen_is_vectorizable<Eigen::Matrix<S, R, C, O, MR, MC> >
+            {};
+            template<typename S, int R, int C, int O, int MR, int MC> struct is_vectorizable<Eigen::Array<S, R, C, O, MR, MC> >
+                : public eigen_is_vectorizable<Eigen::Array<S, R, C, O, MR, MC> >
+            {};
+            template<typename P, int M, typename St> struct is_vectorizable<Eigen::Map<P, M, St> >
+                : public eigen_is_vectorizable<Eigen::Map<P, M, St> >
+            {};
+
+            template<typename D> void save_eigen(
+                  archive & ar
+                , std::string const & path
+                , Eigen::DenseBase<D> const & value
+                , std::vector<std::size_t> size
+                , std::vector<std::size_t> chunk
+                , std::vector<std::size_t> offset
+            ) {
+                typedef typename alps::detail::remove_cvr<typename D::Scalar>::type value_type;
+                using alps::hdf5::get_extent;
+                using alps::hdf5::get_pointer;
+                if (!is_continuous<value_type>::value)
+                    throw wrong_type("invalid type" + ALPS_STACKTRACE);
+                if (ar.is_group(path))
+                    ar.delete_group(path);
+                if (value.size() == 0 && size.size() == 0)
+                    ar.write(path, static_cast<typename scalar_type<value_type>::type const *>(NULL), std::vector<std::size_t>());
+                else {
+                    std::vector<std::size_t> extent(get_extent(value.derived()));
+                    std::copy(extent.begin(), extent.end(), std::back_inserter(size));
+                    std::copy(extent.begin(), extent.end(), std::back_inserter(chunk));
+                    std::fill_n(std::back_inserter(offset), extent.size(), 0);
+                    if (eigen_is_row_contiguous(value))
+                        ar.write(path, get_pointer(*value.derived().data()), size, chunk, offset);
+                    else {
+                        Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> buffer(value.rows(), value.cols());
+                        buffer = value.derived();
+                        ar.write(path, get_pointer(*buffer.data()), size, chunk, offset);
+                    }
+                }
+            }
+
+            template<typename D> void load_eigen(
+                  archive & ar
+                , std::string const & path
+                , D & value
+                , std::vector<std::size_t> chunk
+                , std::vector<std::size_t> offset
+            ) {
+                typedef typename alps::detail::remove_cvr<typename D::Scalar>::type value_type;
+                using alps::hdf5::get_extent;
+                using alps::hdf5::set_extent;
+                using alps::hdf5::get_pointer;
+                if (ar.is_group(path) || !is_continuous<value_type>::value)
+                    throw invalid_path("invalid path" + ALPS_STACKTRACE);
+                if (ar.is_complex(path) != has_complex_elements<value_type>::value)
+                    throw archive_error("no complex value in archive" + ALPS_STACKTRACE);
+                std::vector<std::size_t> size(ar.extent(path));
+                if (size.size() < chunk.size())
+                    throw archive_error("invalid dimensions" + ALPS_STACKTRACE);
+                std::vector<std::size_t> local(size.begin() + chunk.size(), size.end());
+                if (ar.is_null(path))
+                    local = std::vector<std::size_t>(D::IsVectorAtCompileTime ? 1 : 2, 0);
+                else if (local.size() != eigen_shape(value).size() + get_extent(value_type()).size())
+                    throw archive_error("dimensions do not match" + ALPS_STACKTRACE);
+                set_extent(value, local);
+                if (value.size() == 0)
+                    return;
+                std::copy(local.begin(), local.end(), std::back_inserter(chunk));
+                std::fill_n(std::back_inserter(offset), size.size() - offset.size(), 0);
+                if (eigen_is_row_contiguous(value))
+                    ar.read(path, get_pointer(*value.data()), chunk, offset);
+                else {
+                    Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> buffer(value.rows(), value.cols());
+                    ar.read(path, get_pointer(*buffer.data()), chunk, offset);
+                    value = buffer;
+                }
+            }
+        }
+
+        template<typename S, int R, int C, int O, int MR, int MC> void save(
+              archive & ar
+            , std::string const & path
+            , Eigen::Matrix<S, R, C, O, MR, MC> const & value
+            , std::vector<std::size_t> size = std::vector<std::size_t>()
+            , std::vector<std::size_t> chunk = std::vector<std::size_t>()
+            , std::vector<std::size_t> offset = std::vector<std::size_t>()
+        ) {
+            detail::save_eigen(ar, path, value, size, chunk, offset);
+        }
+
+        template<typename S, int R, int C, int O, int MR, int MC> void save(
+              archive & ar
+            , std::string const & path
+            , Eigen::Array<S, R, C, O, MR, MC> const & value
+            , std::vector<std::size_t> size = std::vector<std::size_t>()
+            , std::vector<std::size_t> chunk = std::vector<std::size_t>()
+            , std::vector<std::size_t> offset = std::vector<std::size_t>()
+        ) {
+            detail::save_eigen(ar, path, value, size, chunk, offset);
+        }
+
+        template<typename P, int M, typename St> void save(
+              archive & ar
+            , std::string const & path
+            , Eigen::Map<P, M, St> const & value
+            , std::vector<std::size_t> size = std::vector<std::size_t>()
+            , std::vector<std::size_t> chunk = std::vector<std::size_t>()
+            , std::vector<std::size_t> offset = std::vector<std::size_t>()
+        ) {
+            detail::save_eigen(ar, path, value, size, chunk, offset);
+        }
+
+        template<typename S, int R, int C, int O, int MR, int MC> void load(
+              archive & ar
+            , std::string const & path
+            , Eigen::Matrix<S, R, C, O, MR, MC> & value
+            , std::vector<std::size_t> chunk = std::vector<std::size_t>()
+            , std::vector<std::size_t> offset = std::vector<std::size_t>()
+        ) {
+            detail::load_eigen(ar, path, value, chunk, offset);
+        }
+
+        template<typename S, int R, int C, int O, int MR, int MC> void load(
+              archive & ar
+            , std::string const & path
+            , Eigen::Array<S, R, C, O, MR, MC> & value
+            , std::vector<std::size_t> chunk = std::vector<std::size_t>()
+            , std::vector<std::size_t> offset = std::vector<std::size_t>()
+        ) {
+            detail::load_eigen(ar, path, value, chunk, offset);
+        }
+
+        template<typename P, int M, typename St> void load(
+              archive & ar
+            , std::string const & path
+            , Eigen::Map<P, M, St> & value
+            , std::vector<std::size_t> chunk = std::vector<std::size_t>()
+            , std::vector<std::size_t> offset = std::vector<std::size_t>()
+        ) {
+            detail::load_eigen(ar, path, value, chunk, offset);
+        }
+    }
+}
+
+#endif
@@ -204,6 +204,26 @@ namespace alps {
                 }
             }
         }
+        template<typename T, std::size_t N, typename A> void load_slice(
+              archive & ar
+            , std::string const & path
+            , boost::multi_array<T, N, A> & value
+            , std::vector<range> const & ranges
+        ) {
+            if (!is_continuous<T>::value)
+                throw wrong_type("slices can only be loaded into arrays of continuous types: " + path + ALPS_STACKTRACE);
+            if (ar.is_complex(path) != has_complex_elements<T>::value)
+                throw archive_error("no complex value in archive" + ALPS_STACKTRACE);
+            std::vector<std::size_t> chunk, offset, stride;
+            std::vector<std::size_t> size(detail::resolve_slice(ar, path, ranges, chunk, offset, stride));
+            if (has_complex_elements<T>::value && chunk.back() != 2)
+                throw archive_error("real and imaginary parts cannot be sliced: " + path + ALPS_STACKTRACE);
+            if (size.size() != boost::multi_array<T, N, A>::dimensionality + get_extent(T()).size())
+                throw archive_error("dimensions of the slice do not match: " + path + ALPS_STACKTRACE);
+            set_extent(value, size);
+            if (value.num_elements())
+                ar.read(path, get_pointer(value), chunk, offset, stride);
+        }
         // template<typename T, std::size_t N, typename A> void load(
         //       archive & ar
         //     , std::string const & path
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#ifndef ALPS_HDF5_PROFILING_HPP_INCLUDED_8d1b6f3e2a0c47e5a9c4f7b2e6d03a18
+#define ALPS_HDF5_PROFILING_HPP_INCLUDED_8d1b6f3e2a0c47e5a9c4f7b2e6d03a18
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/utilities/profiling.hpp>
+
+namespace alps {
+    namespace hdf5 {
+
+        namespace detail {
+            inline void save_profiling_statistics(archive& ar, const std::string& path,
+                                                  const alps::profiling::report::statistics_map& stats)
+            {
+                typedef alps::profiling::report::statistics_map map_type;
+                for (map_type::const_iterator it=stats.begin(); it!=stats.end(); ++it) {
+                    const std::string name=path+"/"+ar.encode_segment(it->first);
+                    ar[name+"/count"] << static_cast<unsigned long long>(it->second.count);
+                    ar[name+"/total"] << it->second.total;
+                    ar[name+"/min"] << it->second.min;
+                    ar[name+"/max"] << it->second.max;
+                }
+            }
+
+            inline void load_profiling_statistics(archive& ar, const std::string& path,
+                                                  alps::profiling::report::statistics_map& stats)
+            {
+                stats.clear();
+                if (!ar.is_group(path)) return;
+                const std::vector<std::string> names=ar.list_children(path);
+                for (std::size_t i=0; i<names.size(); ++i) {
+                    const std::string name=path+"/"+names[i];
+                    alps::profiling::statistics& st=stats[ar.decode_segment(names[i])];
+                    unsigned long long count;
+                    ar[name+"/count"] >> count;
+                    st.count=count;
+                    ar[name+"/total"] >> st.total;
+                    ar[name+"/min"] >> st.min;
+                    ar[name+"/max"] >> st.max;
+                }
+            }
+        }
+
+        /// Saves profiling data: statistics under `timers/` and `counters/` (one group per name), trace events under `events/`
+        inline void save(archive& ar, const std::string& path,
+                         const alps::profiling::report& value,
+                         std::vector<std::size_t> /*size*/=std::vector<std::size_t>(),
+                         std::vector<std::size_t> /*chunk*/=std::vector<std::size_t>(),
+                         std::vector<std::size_t> /*offset*/=std::vector<std::size_t>())
+        {
+            const std::string cpath=ar.complete_path(path);
+            if (ar.is_group(cpath)) ar.delete_group(cpath);
+            ar.create_group(cpath);
+            detail::save_profiling_statistics(ar, cpath+"/timers", value.timers);
+            detail::save_profiling_statistics(ar, cpath+"/counters", value.counters);
+            if (value.events.empty()) return;
+
+            const std::size_t n=value.events.size();
+            std::vector<std::string> names(n);
+            std::vector<double> begins(n), durations(n);
+            std::vector<int> processes(n), threads(n);
+            for (std::size_t i=0; i<n; ++i) {
+                names[i]=value.events[i].name;
+                begins[i]=value.events[i].begin;
+                durations[i]=value.events[i].duration;
+                processes[i]=value.events[i].process;
+                threads[i]=value.events[i].thread;
+            }
+            ar[cpath+"/events/name"] << names;
+            ar[cpath+"/events/begin"] << begins;
+            ar[cpath+"/events/duration"] << durations;
+            ar[cpath+"/events/process"] << processes;
+            ar[cpath+"/events/thread"] << threads;
+        }
+
+        /// Loads profiling data
+        inline void load(archive& ar, const std::string& path,
+                         alps::profiling::report& value,
+                         std::vector<std::size_t> /*chunk*/=std::vector<std::size_t>(),
+                         std::vector<std::size_t> /*offset*/=std::vector<std::size_t>())
+        {
+            const std::string cpath=ar.complete_path(path);
+            detail::load_profiling_statistics(ar, cpath+"/timers", value.timers);
+            detail::load_profiling_statistics(ar, cpath+"/counters", value.counters);
+            value.events.clear();
+            if (!ar.is_group(cpath+"/events")) return;
+
+            std::vector<std::string> names;
+            std::vector<double> begins, durations;
+            std::vector<int> processes, threads;
+            ar[cpath+"/events/name"] >> names;
+            ar[cpath+"/events/begin"] >> begins;
+            ar[cpath+"/events/duration"] >> durations;
+            ar[cpath+"/events/process"] >> processes;
+            ar[cpath+"/events/thread"] >> threads;
+            value.events.resize(names.size());
+            for (std::size_t i=0; i<names.size(); ++i) {
+                value.events[i].name=names[i];
+                value.events[i].begin=begins[i];
+                value.events[i].duration=durations[i];
+                value.events[i].process=processes[i];
+                value.events[i].thread=threads[i];
+            }
+        }
+
+    } // hdf5::
+} // alps::
+
+#endif /* ALPS_HDF5_PROFILING_HPP_INCLUDED_8d1b6f3e2a0c47e5a9c4f7b2e6d03a18 */
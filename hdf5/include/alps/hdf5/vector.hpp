@@ -140,6 +140,25 @@ namespace alps {
                 }
             };
 
+            // loads the children of a group named by their index into a vector, see archive::visit_children()
+            template<typename T, typename A> struct load_vector_child {
+                load_vector_child(archive & ar, std::string const & path, std::vector<T, A> & value)
+                    : ar_(ar), path_(path), value_(value)
+                {}
+
+                bool operator()(std::string const & name, archive::child_type) {
+                    std::size_t index = alps::cast<std::size_t>(name);
+                    if (index >= value_.size())
+                        value_.resize(index + 1);
+                    load(ar_, path_ + "/" + name, value_[index]);
+                    return true;
+                }
+
+                archive & ar_;
+                std::string path_;
+                std::vector<T, A> & value_;
+            };
+
         }
 
 
@@ -213,12 +232,9 @@ namespace alps {
             , std::vector<std::size_t> chunk = std::vector<std::size_t>()
             , std::vector<std::size_t> offset = std::vector<std::size_t>()
         ) {
-            using alps::cast;
             if (ar.is_group(path)) {
-                std::vector<std::string> children = ar.list_children(path);
-                value.resize(children.size());
-                for (typename std::vector<std::string>::const_iterator it = children.begin(); it != children.end(); ++it)
-                   load(ar, ar.complete_path(path) + "/" + *it, value[cast<std::size_t>(*it)]);
+                value.clear();
+                ar.visit_children(path, detail::load_vector_child<T, A>(ar, ar.complete_path(path), value));
             } else {
                 if (ar.is_complex(path) != has_complex_elements<T>::value)
                     throw archive_error("no complex value in archive" + ALPS_STACKTRACE);
@@ -246,6 +262,27 @@ namespace alps {
             }
         }
 
+        template<typename T, typename A> void load_slice(
+              archive & ar
+            , std::string const & path
+            , std::vector<T, A> & value
+            , std::vector<range> const & ranges
+        ) {
+            if (!is_continuous<T>::value)
+                throw wrong_type("slices can only be loaded into vectors of continuous types: " + path + ALPS_STACKTRACE);
+            if (ar.is_complex(path) != has_complex_elements<T>::value)
+                throw archive_error("no complex value in archive" + ALPS_STACKTRACE);
+            std::vector<std::size_t> chunk, offset, stride;
+            std::vector<std::size_t> size(detail::resolve_slice(ar, path, ranges, chunk, offset, stride));
+            if (has_complex_elements<T>::value && chunk.back() != 2)
+                throw archive_error("real and imaginary parts cannot be sliced: " + path + ALPS_STACKTRACE);
+            if (size.size() == 0)
+                size.push_back(1);
+            set_extent(value, size);
+            if (value.size())
+                ar.read(path, get_pointer(value), chunk, offset, stride);
+        }
+
         template<typename A> void load(
               archive & ar
             , std::string const & path
@@ -8,6 +8,7 @@
 #include <alps/utilities/cast.hpp>
 #include <alps/utilities/signal.hpp>
 #include <alps/utilities/stacktrace.hpp>
+#include <alps/utilities/profiling.hpp>
 
 #include <boost/scoped_array.hpp>
 #include <boost/noncopyable.hpp>
@@ -17,9 +18,11 @@
 #include <hdf5.h>
 
 #include <sstream>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <typeinfo>
+#include <exception>
 
 #ifdef ALPS_SINGLE_THREAD
     #define ALPS_HDF5_LOCK_MUTEX
@@ -150,6 +153,8 @@ namespace alps {
             typedef resource<H5Sclose> space_type;
             typedef resource<H5Tclose> type_type;
             typedef resource<H5Pclose> property_type;
+            typedef resource<H5Oclose> object_type;
+            typedef resource<H5Fclose> file_type;
             typedef resource<noop> error_type;
 
             hid_t check_group(hid_t id) { group_type unused(id); return unused; }
@@ -197,6 +202,146 @@ namespace alps {
                 return 0;
             }
 
+            template<typename V> struct visit_children_context {
+                V & visitor;
+                std::exception_ptr error;
+            };
+
+            // exceptions must not propagate through the HDF5 library, they are rethrown after the iteration
+            template<typename V> herr_t visit_children_visitor(hid_t group_id, char const * n, const H5L_info_t *, void * d) {
+                visit_children_context<V> & context = *reinterpret_cast<visit_children_context<V> *>(d);
+                try {
+                    archive::child_type type = archive::OTHER;
+                    hid_t id = H5Oopen(group_id, n, H5P_DEFAULT);
+                    if (id >= 0) {
+                        object_type object_id(id);
+                        if (H5Iget_type(object_id) == H5I_GROUP)
+                            type = archive::GROUP;
+                        else if (H5Iget_type(object_id) == H5I_DATASET)
+                            type = archive::DATA;
+                    }
+                    return context.visitor.visit(n, type) ? 0 : 1;
+                } catch (...) {
+                    context.error = std::current_exception();
+                    return -1;
+                }
+            }
+
+            // sets *d if a dataset below the group carries a scalar complex flag, recursing on the open handles
+            herr_t is_complex_visitor(hid_t group_id, char const * n, const H5L_info_t *, void * d) {
+                bool & result = *reinterpret_cast<bool *>(d);
+                try {
+                    object_type object_id(H5Oopen(group_id, n, H5P_DEFAULT));
+                    if (H5Iget_type(object_id) == H5I_GROUP)
+                        check_error(H5Literate(object_id, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, is_complex_visitor, d));
+                    else if (H5Iget_type(object_id) == H5I_DATASET && check_error(H5Aexists(object_id, "__complex__")) > 0) {
+                        attribute_type attr_id(H5Aopen(object_id, "__complex__", H5P_DEFAULT));
+                        space_type space_id(H5Aget_space(attr_id));
+                        result = H5Sget_simple_extent_type(space_id) == H5S_SCALAR;
+                    }
+                } catch (...) {
+                    return -1;
+                }
+                return result ? 1 : 0;
+            }
+
+            struct shard_files : boost::noncopyable {
+                ~shard_files() {
+                    for (std::vector<hid_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+                        H5Fclose(*it);
+                }
+                std::vector<hid_t> ids;
+            };
+
+            bool link_exists(hid_t file_id, std::string const & path) {
+                for (std::size_t pos = path.find_first_of('/'); pos != std::string::npos; pos = path.find_first_of('/', pos + 1))
+                    if (check_error(H5Lexists(file_id, path.substr(0, pos).c_str(), H5P_DEFAULT)) == 0)
+                        return false;
+                return check_error(H5Lexists(file_id, path.c_str(), H5P_DEFAULT)) > 0;
+            }
+
+            bool has_variable_length(hid_t type_id) {
+                return check_error(H5Tdetect_class(type_id, H5T_VLEN)) > 0 || check_error(H5Tis_variable_str(type_id)) > 0;
+            }
+
+            void copy_attributes(hid_t source_id, hid_t target_id) {
+                std::vector<std::string> names;
+                check_error(H5Aiterate2(source_id, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, list_attributes_visitor, &names));
+                for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+                    attribute_type source_attr_id(H5Aopen(source_id, it->c_str(), H5P_DEFAULT));
+                    type_type type_id(H5Aget_type(source_attr_id));
+                    type_type native_id(H5Tget_native_type(type_id, H5T_DIR_ASCEND));
+                    space_type space_id(H5Aget_space(source_attr_id));
+                    attribute_type target_attr_id(H5Acreate2(target_id, it->c_str(), type_id, space_id, H5P_DEFAULT, H5P_DEFAULT));
+                    if (std::size_t size = check_error(H5Sget_simple_extent_npoints(space_id))) {
+                        std::vector<char> buffer(size * H5Tget_size(native_id));
+                        check_error(H5Aread(source_attr_id, native_id, &buffer.front()));
+                        herr_t status = H5Awrite(target_attr_id, native_id, &buffer.front());
+                        if (has_variable_length(native_id))
+                            check_error(H5Dvlen_reclaim(native_id, space_id, H5P_DEFAULT, &buffer.front()));
+                        check_error(status);
+                    }
+                }
+            }
+
+            // maps the dataset `path` of all shards into one virtual dataset of the master file. Non-scalar datasets
+            // are concatenated along the first dimension, null datasets contribute no rows, scalars are stacked
+            // into a vector. Returns false if the path is missing in a shard or the shards disagree on the layout.
+            bool stitch_data(std::vector<std::string> const & shards, shard_files const & files, hid_t master_id, std::string const & path) {
+                data_type first_id(H5Dopen2(files.ids.front(), path.c_str(), H5P_DEFAULT));
+                type_type type_id(H5Dget_type(first_id));
+                if (has_variable_length(type_id))
+                    return false;
+                int rank = -1;
+                std::vector<hsize_t> extent, rows(files.ids.size(), 0);
+                for (std::size_t i = 0; i < files.ids.size(); ++i) {
+                    if (!link_exists(files.ids[i], path))
+                        return false;
+                    data_type data_id(H5Dopen2(files.ids[i], path.c_str(), H5P_DEFAULT));
+                    type_type shard_type_id(H5Dget_type(data_id));
+                    space_type space_id(H5Dget_space(data_id));
+                    if (check_error(H5Tequal(type_id, shard_type_id)) == 0)
+                        return false;
+                    if (H5Sget_simple_extent_type(space_id) == H5S_NULL)
+                        continue;
+                    int shard_rank = check_error(H5Sget_simple_extent_ndims(space_id));
+                    std::vector<hsize_t> shard_extent(std::max(shard_rank, 1), 1);
+                    check_error(H5Sget_simple_extent_dims(space_id, &shard_extent.front(), NULL));
+                    rows[i] = shard_extent.front();
+                    shard_extent.front() = 0;
+                    if (rank == -1) {
+                        rank = shard_rank;
+                        extent = shard_extent;
+                    } else if (rank != shard_rank || extent != shard_extent)
+                        return false;
+                }
+                if (rank == -1) {
+                    space_type space_id(H5Screate(H5S_NULL));
+                    data_type data_id(H5Dcreate2(master_id, path.c_str(), type_id, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT));
+                    copy_attributes(first_id, data_id);
+                    return true;
+                }
+                if (rank == 0 && std::find(rows.begin(), rows.end(), 0) != rows.end())
+                    return false;
+                for (std::vector<hsize_t>::const_iterator it = rows.begin(); it != rows.end(); ++it)
+                    extent.front() += *it;
+                property_type prop_id(H5Pcreate(H5P_DATASET_CREATE));
+                std::vector<hsize_t> start(extent.size(), 0), count(extent);
+                for (std::size_t i = 0; i < files.ids.size(); start.front() += rows[i++])
+                    if (rows[i]) {
+                        data_type data_id(H5Dopen2(files.ids[i], path.c_str(), H5P_DEFAULT));
+                        space_type source_space_id(H5Dget_space(data_id));
+                        space_type virtual_space_id(H5Screate_simple(extent.size(), &extent.front(), NULL));
+                        count.front() = rows[i];
+                        check_error(H5Sselect_hyperslab(virtual_space_id, H5S_SELECT_SET, &start.front(), NULL, &count.front(), NULL));
+                        check_error(H5Pset_virtual(prop_id, virtual_space_id, shards[i].c_str(), ("/" + path).c_str(), source_space_id));
+                    }
+                space_type space_id(H5Screate_simple(extent.size(), &extent.front(), NULL));
+                data_type data_id(H5Dcreate2(master_id, path.c_str(), type_id, space_id, H5P_DEFAULT, prop_id, H5P_DEFAULT));
+                copy_attributes(first_id, data_id);
+                return true;
+            }
+
             struct archivecontext : boost::noncopyable {
 
                 archivecontext(std::string const & filename, bool write, bool replace, bool compress, bool memory)
@@ -230,6 +375,8 @@ namespace alps {
                 std::string filename_;
                 std::string filename_new_;
                 hid_t file_id_;
+                // complex-ness per absolute path, cleared whenever the file is modified
+                std::map<std::string, bool> complex_cache_;
                 
                 private:
 
@@ -553,20 +700,22 @@ namespace alps {
         bool archive::is_complex(std::string path) const {
             if (context_ == NULL)
                 throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
-            ALPS_HDF5_FAKE_THREADSAFETY
-            if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
-                return is_attribute(path.substr(0, path.find_last_of('@')) + "@__complex__:" + path.substr(path.find_last_of('@') + 1))
-                    && is_scalar(path.substr(0, path.find_last_of('@')) + "@__complex__:" + path.substr(path.find_last_of('@') + 1));
+            ALPS_HDF5_LOCK_MUTEX
+            std::map<std::string, bool>::const_iterator it = context_->complex_cache_.find(path = complete_path(path));
+            if (it != context_->complex_cache_.end())
+                return it->second;
+            bool result = false;
+            if (path.find_last_of('@') != std::string::npos)
+                result = is_attribute(path.substr(0, path.find_last_of('@')) + "@__complex__:" + path.substr(path.find_last_of('@') + 1))
+                      && is_scalar(path.substr(0, path.find_last_of('@')) + "@__complex__:" + path.substr(path.find_last_of('@') + 1));
             else if (is_group(path)) {
-                std::vector<std::string> children = list_children(path);
-                for (std::size_t i = 0; i < children.size(); ++i)
-                    if (is_complex(path + "/" + children[i]))
-                        return true;
-                return false;
+                detail::group_type group_id(H5Gopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+                detail::check_error(H5Literate(group_id, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, detail::is_complex_visitor, &result));
             } else
-                return is_attribute(path + "/@__complex__") && is_scalar(path + "/@__complex__");
+                result = is_attribute(path + "/@__complex__") && is_scalar(path + "/@__complex__");
+            return context_->complex_cache_[path] = result;
         }
-    
+
         std::vector<std::string> archive::list_children(std::string path) const {
             if (context_ == NULL)
                 throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
@@ -581,6 +730,22 @@ namespace alps {
             return list;
         }
     
+        void archive::visit_children_impl(std::string path, children_visitor & visitor) const {
+            if (context_ == NULL)
+                throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
+            if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
+                throw invalid_path("no group path: " + path + ALPS_STACKTRACE);
+            ALPS_HDF5_FAKE_THREADSAFETY
+            if (!is_group(path))
+                throw path_not_found("The group '" + path + "' does not exist." + ALPS_STACKTRACE);
+            detail::group_type group_id(H5Gopen2(context_->file_id_, path.c_str(), H5P_DEFAULT));
+            detail::visit_children_context<children_visitor> context = { visitor, std::exception_ptr() };
+            herr_t status = H5Literate(group_id, H5_INDEX_NAME, H5_ITER_NATIVE, NULL, detail::visit_children_visitor<children_visitor>, &context);
+            if (context.error)
+                std::rethrow_exception(context.error);
+            detail::check_error(status);
+        }
+
         std::vector<std::string> archive::list_attributes(std::string path) const {
             if (context_ == NULL)
                 throw archive_closed("the archive is closed" + ALPS_STACKTRACE);
@@ -641,6 +806,10 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 throw invalid_path("no group path: " + path + ALPS_STACKTRACE);
             ALPS_HDF5_FAKE_THREADSAFETY
+            {
+                ALPS_HDF5_LOCK_MUTEX
+                context_->complex_cache_.clear();
+            }
             if (is_data(path))
                 delete_data(path);
             if (!is_group(path)) {
@@ -678,6 +847,10 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 throw invalid_path("no data path: " + path + ALPS_STACKTRACE);
             ALPS_HDF5_FAKE_THREADSAFETY
+            {
+                ALPS_HDF5_LOCK_MUTEX
+                context_->complex_cache_.clear();
+            }
             if (is_data(path))
                 detail::check_error(H5Ldelete(context_->file_id_, path.c_str(), H5P_DEFAULT));
             else if (is_group(path))
@@ -690,6 +863,10 @@ namespace alps {
             if ((path = complete_path(path)).find_last_of('@') != std::string::npos)
                 throw invalid_path("no group path: " + path + ALPS_STACKTRACE);
             ALPS_HDF5_FAKE_THREADSAFETY
+            {
+                ALPS_HDF5_LOCK_MUTEX
+                context_->complex_cache_.clear();
+            }
             if (is_group(path))
                 detail::check_error(H5Ldelete(context_->file_id_, path.c_str(), H5P_DEFAULT));
             else if (is_data(path))
@@ -742,6 +919,7 @@ namespace alps {
         #define ALPS_HDF5_READ_SCALAR(T)                                                                                                                                \
             void archive::read(std::string path, T & value) const {                                                                                                     \
                 ALPS_HDF5_FAKE_THREADSAFETY                                                                                                                             \
+                ALPS_PROFILE_SCOPE("hdf5.read");                                                                                                                        \
                 if (context_ == NULL)                                                                                                                                   \
                     throw archive_closed("the archive is closed" + ALPS_STACKTRACE);                                                                                    \
                 if ((path = complete_path(path)).find_last_of('@') == std::string::npos) {                                                                              \
@@ -800,20 +978,22 @@ namespace alps {
             ) > 0) {                                                                                                                                                    \
                 std::size_t len = std::accumulate(chunk.begin(), chunk.end(), std::size_t(1), std::multiplies<std::size_t>());                                          \
                 boost::scoped_array<U> raw(                                                                                                                             \
-                    new alps::detail::type_wrapper< U >::type[len]                                                                                                      \
+                    boost::is_same< U , T >::value ? NULL : new alps::detail::type_wrapper< U >::type[len]                                                              \
                 );                                                                                                                                                      \
-                if (std::equal(chunk.begin(), chunk.end(), data_size.begin())) {                                                                                        \
-                    detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, raw.get()));                                                         \
-                    cast(raw.get(), raw.get() + len, value);                                                                                                            \
-                } else {                                                                                                                                                \
+                U * target = boost::is_same< U , T >::value ? reinterpret_cast<U *>(value) : raw.get();                                                                 \
+                if (std::equal(chunk.begin(), chunk.end(), data_size.begin()))                                                                                          \
+                    detail::check_error(H5Dread(data_id, native_id, H5S_ALL, H5S_ALL, H5P_DEFAULT, target));                                                            \
+                else {                                                                                                                                                  \
                     std::vector<hsize_t> offset_hid(offset.begin(), offset.end()),                                                                                      \
-                                         chunk_hid(chunk.begin(), chunk.end());                                                                                         \
+                                         chunk_hid(chunk.begin(), chunk.end()),                                                                                         \
+                                         stride_hid(stride.begin(), stride.end());                                                                                      \
                     detail::space_type space_id(H5Dget_space(data_id));                                                                                                 \
-                    detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), NULL, &chunk_hid.front(), NULL));                            \
+                    detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), &stride_hid.front(), &chunk_hid.front(), NULL));             \
                     detail::space_type mem_id(H5Screate_simple(static_cast<int>(chunk_hid.size()), &chunk_hid.front(), NULL));                                          \
-                    detail::check_error(H5Dread(data_id, native_id, mem_id, space_id, H5P_DEFAULT, raw.get()));                                                         \
-                    cast(raw.get(), raw.get() + len, value);                                                                                                            \
-                }
+                    detail::check_error(H5Dread(data_id, native_id, mem_id, space_id, H5P_DEFAULT, target));                                                            \
+                }                                                                                                                                                       \
+                if (!boost::is_same< U , T >::value)                                                                                                                    \
+                    cast(raw.get(), raw.get() + len, value);
         #define ALPS_HDF5_READ_VECTOR_ATTRIBUTE_HELPER(U, T)                                                                                                            \
             } else if (detail::check_error(                                                                                                                             \
                 H5Tequal(detail::type_type(H5Tcopy(native_id)), detail::type_type(detail::get_native_type(alps::detail::type_wrapper< U >::type())))                    \
@@ -828,17 +1008,20 @@ namespace alps {
                 } else                                                                                                                                                  \
                     throw std::logic_error("Not Implemented, path: " + path + ALPS_STACKTRACE);
         #define ALPS_HDF5_READ_VECTOR(T)                                                                                                                                \
-            void archive::read(std::string path, T * value, std::vector<std::size_t> chunk, std::vector<std::size_t> offset) const {                                    \
+            void archive::read(std::string path, T * value, std::vector<std::size_t> chunk, std::vector<std::size_t> offset, std::vector<std::size_t> stride) const {   \
                 ALPS_HDF5_FAKE_THREADSAFETY                                                                                                                             \
+                ALPS_PROFILE_SCOPE("hdf5.read");                                                                                                                        \
                 if (context_ == NULL)                                                                                                                                   \
                     throw archive_closed("the archive is closed" + ALPS_STACKTRACE);                                                                                    \
                 std::vector<std::size_t> data_size = extent(path);                                                                                                      \
                 if (offset.size() == 0)                                                                                                                                 \
                     offset = std::vector<std::size_t>(dimensions(path), 0);                                                                                             \
-                if (data_size.size() != chunk.size() || data_size.size() != offset.size())                                                                              \
-                    throw archive_error("wrong size or offset passed for path: " + path + ALPS_STACKTRACE);                                                             \
+                if (stride.size() == 0)                                                                                                                                 \
+                    stride = std::vector<std::size_t>(offset.size(), 1);                                                                                                \
+                if (data_size.size() != chunk.size() || data_size.size() != offset.size() || data_size.size() != stride.size())                                         \
+                    throw archive_error("wrong size, offset or stride passed for path: " + path + ALPS_STACKTRACE);                                                     \
                 for (std::size_t i = 0; i < data_size.size(); ++i)                                                                                                      \
-                    if (data_size[i] < chunk[i] + offset[i])                                                                                                            \
+                    if (stride[i] == 0 || data_size[i] < offset[i] + (chunk[i] ? (chunk[i] - 1) * stride[i] + 1 : 0))                                                   \
                         throw archive_error("passed size of offset exeed data size for path: " + path + ALPS_STACKTRACE);                                               \
                 if (is_null(path))                                                                                                                                      \
                     value = NULL;                                                                                                                                       \
@@ -867,9 +1050,10 @@ namespace alps {
                                 detail::check_error(H5Dvlen_reclaim(type_id, detail::space_type(H5Dget_space(data_id)), H5P_DEFAULT, raw.get()));                       \
                             } else {                                                                                                                                    \
                                 std::vector<hsize_t> offset_hid(offset.begin(), offset.end()),                                                                          \
-                                                     chunk_hid(chunk.begin(), chunk.end());                                                                             \
+                                                     chunk_hid(chunk.begin(), chunk.end()),                                                                             \
+                                                     stride_hid(stride.begin(), stride.end());                                                                          \
                                 detail::space_type space_id(H5Dget_space(data_id));                                                                                     \
-                                detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), NULL, &chunk_hid.front(), NULL));                \
+                                detail::check_error(H5Sselect_hyperslab(space_id, H5S_SELECT_SET, &offset_hid.front(), &stride_hid.front(), &chunk_hid.front(), NULL)); \
                                 detail::space_type mem_id(H5Screate_simple(static_cast<int>(chunk_hid.size()), &chunk_hid.front(), NULL));                              \
                                 detail::check_error(H5Dread(data_id, native_id, mem_id, space_id, H5P_DEFAULT, raw.get()));                                             \
                                 cast(raw.get(), raw.get() + len, value);                                                                                                \
@@ -925,10 +1109,15 @@ namespace alps {
         #define ALPS_HDF5_WRITE_SCALAR(T)                                                                                                                               \
             void archive::write(std::string path, T value) const {                                                                                                      \
                 ALPS_HDF5_FAKE_THREADSAFETY                                                                                                                             \
+                ALPS_PROFILE_SCOPE("hdf5.write");                                                                                                                       \
                 if (context_ == NULL)                                                                                                                                   \
                     throw archive_closed("the archive is closed" + ALPS_STACKTRACE);                                                                                    \
                 if (!context_->write_)                                                                                                                                  \
                     throw archive_error("the archive is not writeable" + ALPS_STACKTRACE);                                                                              \
+                {                                                                                                                                                       \
+                    ALPS_HDF5_LOCK_MUTEX                                                                                                                                \
+                    context_->complex_cache_.clear();                                                                                                                   \
+                }                                                                                                                                                       \
                 hid_t data_id;                                                                                                                                          \
                 if ((path = complete_path(path)).find_last_of('@') == std::string::npos) {                                                                              \
                     if (is_group(path))                                                                                                                                 \
@@ -1018,10 +1207,15 @@ namespace alps {
                 std::string path, T const * value, std::vector<std::size_t> size, std::vector<std::size_t> chunk, std::vector<std::size_t> offset                       \
             ) const {                                                                                                                                                   \
                 ALPS_HDF5_FAKE_THREADSAFETY                                                                                                                             \
+                ALPS_PROFILE_SCOPE("hdf5.write");                                                                                                                       \
                 if (context_ == NULL)                                                                                                                                   \
                     throw archive_closed("the archive is closed" + ALPS_STACKTRACE);                                                                                    \
                 if (!context_->write_)                                                                                                                                  \
                     throw archive_error("the archive is not writeable" + ALPS_STACKTRACE);                                                                              \
+                {                                                                                                                                                       \
+                    ALPS_HDF5_LOCK_MUTEX                                                                                                                                \
+                    context_->complex_cache_.clear();                                                                                                                   \
+                }                                                                                                                                                       \
                 if (chunk.size() == 0)                                                                                                                                  \
                     chunk = std::vector<std::size_t>(size.begin(), size.end());                                                                                         \
                 if (offset.size() == 0)                                                                                                                                 \
@@ -1091,7 +1285,7 @@ namespace alps {
                                 std::size_t dataset_size = std::accumulate(size.begin(), size.end(), std::size_t(sizeof( T )), std::multiplies<std::size_t>());         \
                                 if (dataset_size < ALPS_HDF5_SZIP_BLOCK_SIZE * sizeof( T ))                                                                             \
                                     detail::check_error(H5Pset_layout(prop_id, H5D_COMPACT));                                                                           \
-                                else if (dataset_size < (1ULL<<32))                                                                                                     \
+                                else if (dataset_size < (1ULL<<32) && !context_->compress_)                                                                             \
                                     detail::check_error(H5Pset_layout(prop_id, H5D_CONTIGUOUS));                                                                        \
                                 else {                                                                                                                                  \
                                     detail::check_error(H5Pset_layout(prop_id, H5D_CHUNKED));                                                                           \
@@ -1102,9 +1296,10 @@ namespace alps {
                                         , max_chunk.end()                                                                                                               \
                                         , std::size_t(sizeof( T ))                                                                                                      \
                                         , std::multiplies<std::size_t>()                                                                                                \
-                                    ) > (1ULL<<32) - 1) {                                                                                                               \
-                                        max_chunk[index] /= 2;                                                                                                          \
-                                        if (max_chunk[index] == 1)                                                                                                      \
+                                    ) > (context_->compress_ ? ALPS_HDF5_SZIP_CHUNK_SIZE : (1ULL<<32) - 1)) {                                                           \
+                                        if (max_chunk[index] > 1)                                                                                                       \
+                                            max_chunk[index] /= 2;                                                                                                      \
+                                        else                                                                                                                            \
                                             ++index;                                                                                                                    \
                                     }                                                                                                                                   \
                                     detail::check_error(H5Pset_chunk(prop_id, static_cast<int>(max_chunk.size()), &max_chunk.front()));                                 \
@@ -1201,6 +1396,40 @@ namespace alps {
         ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_WRITE_VECTOR)
         #undef ALPS_HDF5_WRITE_VECTOR
 
+        namespace detail {
+            std::vector<std::size_t> resolve_slice(
+                  archive const & ar
+                , std::string const & path
+                , std::vector<range> const & ranges
+                , std::vector<std::size_t> & chunk
+                , std::vector<std::size_t> & offset
+                , std::vector<std::size_t> & stride
+            ) {
+                if (!ar.is_data(path))
+                    throw path_not_found("the path does not exist: " + path + ALPS_STACKTRACE);
+                if (ar.is_scalar(path) || ar.is_null(path))
+                    throw wrong_type("only non-empty multidimensional datasets can be sliced: " + path + ALPS_STACKTRACE);
+                std::vector<std::size_t> data_size = ar.extent(path), shape;
+                if (ranges.size() > data_size.size())
+                    throw archive_error("more ranges than dimensions passed for path: " + path + ALPS_STACKTRACE);
+                chunk.clear();
+                offset.clear();
+                stride.clear();
+                for (std::size_t i = 0; i < data_size.size(); ++i) {
+                    range const selection = i < ranges.size() ? ranges[i] : range();
+                    std::size_t const stop = selection.stop(data_size[i]);
+                    if (selection.stride() == 0 || selection.start() > stop || stop > data_size[i])
+                        throw archive_error("range exceeds the extent of dimension " + cast<std::string>(i) + " of path: " + path + ALPS_STACKTRACE);
+                    offset.push_back(selection.start());
+                    stride.push_back(selection.stride());
+                    chunk.push_back((stop - selection.start() + selection.stride() - 1) / selection.stride());
+                    if (!selection.is_index())
+                        shape.push_back(chunk.back());
+                }
+                return shape;
+            }
+        }
+
         #define ALPS_HDF5_IMPLEMENT_FREE_FUNCTIONS(T)                                                                                                                   \
             namespace detail {                                                                                                                                          \
                 alps::hdf5::scalar_type< T >::type * get_pointer< T >::apply( T & value) {                                                                              \
@@ -1288,6 +1517,46 @@ namespace alps {
         ALPS_FOREACH_NATIVE_HDF5_TYPE(ALPS_HDF5_IS_DATATYPE_IMPL_IMPL)
         #undef ALPS_HDF5_IS_DATATYPE_IMPL_IMPL
 
+        std::vector<std::string> archive::stitch_shards(std::string const & master, std::vector<std::string> const & shards) {
+            ALPS_HDF5_LOCK_MUTEX
+            if (shards.empty())
+                throw archive_error("no shards given for master file " + master + ALPS_STACKTRACE);
+            detail::check_error(H5Eset_auto2(H5E_DEFAULT, NULL, NULL));
+            detail::property_type access_id(H5Pcreate(H5P_FILE_ACCESS));
+            #ifndef ALPS_HDF5_CLOSE_GREEDY
+                detail::check_error(H5Pset_fclose_degree(access_id, H5F_CLOSE_SEMI));
+            #endif
+            detail::shard_files files;
+            for (std::vector<std::string>::const_iterator it = shards.begin(); it != shards.end(); ++it) {
+                hid_t file_id = H5Fopen(it->c_str(), H5F_ACC_RDONLY, access_id);
+                if (file_id < 0)
+                    throw archive_not_found("file does not exists or is not a valid hdf5 archive: " + *it + ALPS_STACKTRACE);
+                files.ids.push_back(file_id);
+            }
+            detail::property_type create_id(H5Pcreate(H5P_FILE_CREATE));
+            detail::check_error(H5Pset_link_creation_order(create_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
+            detail::check_error(H5Pset_attr_creation_order(create_id, (H5P_CRT_ORDER_TRACKED | H5P_CRT_ORDER_INDEXED)));
+            detail::file_type master_id(H5Fcreate(master.c_str(), H5F_ACC_TRUNC, create_id, access_id));
+            {
+                detail::group_type source_id(H5Gopen2(files.ids.front(), "/", H5P_DEFAULT));
+                detail::group_type target_id(H5Gopen2(master_id, "/", H5P_DEFAULT));
+                detail::copy_attributes(source_id, target_id);
+            }
+            // sorted paths list every group before its members
+            std::vector<std::string> paths, skipped;
+            detail::check_error(H5Lvisit(files.ids.front(), H5_INDEX_NAME, H5_ITER_NATIVE, detail::list_children_visitor, &paths));
+            std::sort(paths.begin(), paths.end());
+            for (std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it) {
+                detail::object_type object_id(H5Oopen(files.ids.front(), it->c_str(), H5P_DEFAULT));
+                if (H5Iget_type(object_id) == H5I_GROUP) {
+                    detail::group_type group_id(H5Gcreate2(master_id, it->c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT));
+                    detail::copy_attributes(object_id, group_id);
+                } else if (H5Iget_type(object_id) != H5I_DATASET || !detail::stitch_data(shards, files, master_id, *it))
+                    skipped.push_back("/" + *it);
+            }
+            return skipped;
+        }
+
         void archive::construct(std::string const & filename, std::size_t props) {
             ALPS_HDF5_LOCK_MUTEX
             detail::check_error(H5Eset_auto2(H5E_DEFAULT, NULL, NULL));
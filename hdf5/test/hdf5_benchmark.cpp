@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file hdf5_benchmark.cpp
+    Throughput benchmark of the archive layer; not part of the test suite.
+
+    Usage: hdf5_benchmark [scale [repetitions]]
+
+    Every case is written and read back on disk, on disk with compression and in memory.
+    For each combination the best of `repetitions` runs is reported as MB/s of payload
+    and as operations (save/load calls or listings) per second. `scale` multiplies the
+    problem sizes, the default of 1 keeps the total run time at a few seconds.
+*/
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/hdf5/complex.hpp>
+#include <alps/hdf5/multi_array.hpp>
+#include <alps/utilities/cast.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+namespace {
+
+    typedef std::chrono::steady_clock clock_type;
+
+    struct measurement {
+        double seconds;
+        std::size_t bytes;
+        std::size_t ops;
+    };
+
+    /// Interface of one benchmark case: `write()` and `read()` return the number of bytes and operations
+    class benchmark_case {
+        public:
+            explicit benchmark_case(std::string const & name) : name_(name) {}
+            virtual ~benchmark_case() {}
+            std::string const & name() const { return name_; }
+            virtual void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const = 0;
+            virtual void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const = 0;
+        private:
+            std::string name_;
+    };
+
+    class scalars : public benchmark_case {
+        public:
+            explicit scalars(std::size_t count) : benchmark_case("scalars"), count_(count) {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                for (std::size_t i = 0; i < count_; ++i)
+                    ar["/scalars/" + alps::cast<std::string>(i)] << static_cast<double>(i);
+                bytes = count_ * sizeof(double);
+                ops = count_;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                double value;
+                for (std::size_t i = 0; i < count_; ++i)
+                    ar["/scalars/" + alps::cast<std::string>(i)] >> value;
+                bytes = count_ * sizeof(double);
+                ops = count_;
+            }
+        private:
+            std::size_t count_;
+    };
+
+    class attributes : public benchmark_case {
+        public:
+            explicit attributes(std::size_t count) : benchmark_case("attributes"), count_(count) {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                ar.create_group("/attributes");
+                for (std::size_t i = 0; i < count_; ++i)
+                    ar["/attributes/@a" + alps::cast<std::string>(i)] << static_cast<double>(i);
+                bytes = count_ * sizeof(double);
+                ops = count_;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                double value;
+                for (std::size_t i = 0; i < count_; ++i)
+                    ar["/attributes/@a" + alps::cast<std::string>(i)] >> value;
+                bytes = count_ * sizeof(double);
+                ops = count_;
+            }
+        private:
+            std::size_t count_;
+    };
+
+    class contiguous_vector : public benchmark_case {
+        public:
+            explicit contiguous_vector(std::size_t size) : benchmark_case("vector"), data_(size, 1.5) {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                ar["/vector"] << data_;
+                bytes = data_.size() * sizeof(double);
+                ops = 1;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                std::vector<double> data;
+                ar["/vector"] >> data;
+                bytes = data.size() * sizeof(double);
+                ops = 1;
+            }
+        private:
+            std::vector<double> data_;
+    };
+
+    class nested_vector : public benchmark_case {
+        public:
+            nested_vector(std::size_t rows, std::size_t cols)
+                : benchmark_case("nested_vector"), data_(rows, std::vector<double>(cols, 2.5))
+            {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                ar["/nested_vector"] << data_;
+                bytes = data_.size() * data_.front().size() * sizeof(double);
+                ops = 1;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                std::vector<std::vector<double> > data;
+                ar["/nested_vector"] >> data;
+                bytes = data.size() * data.front().size() * sizeof(double);
+                ops = 1;
+            }
+        private:
+            std::vector<std::vector<double> > data_;
+    };
+
+    class multi_array : public benchmark_case {
+        public:
+            multi_array(std::size_t rows, std::size_t cols)
+                : benchmark_case("multi_array"), data_(boost::extents[rows][cols])
+            {
+                std::fill(data_.data(), data_.data() + data_.num_elements(), 3.5);
+            }
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                ar["/multi_array"] << data_;
+                bytes = data_.num_elements() * sizeof(double);
+                ops = 1;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                boost::multi_array<double, 2> data;
+                ar["/multi_array"] >> data;
+                bytes = data.num_elements() * sizeof(double);
+                ops = 1;
+            }
+        private:
+            boost::multi_array<double, 2> data_;
+    };
+
+    class complex_vector : public benchmark_case {
+        public:
+            explicit complex_vector(std::size_t size)
+                : benchmark_case("complex_vector"), data_(size, std::complex<double>(1., -1.))
+            {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                ar["/complex_vector"] << data_;
+                bytes = data_.size() * sizeof(std::complex<double>);
+                ops = 1;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                std::vector<std::complex<double> > data;
+                ar["/complex_vector"] >> data;
+                bytes = data.size() * sizeof(std::complex<double>);
+                ops = 1;
+            }
+        private:
+            std::vector<std::complex<double> > data_;
+    };
+
+    class small_datasets : public benchmark_case {
+        public:
+            small_datasets(std::size_t count, std::size_t size)
+                : benchmark_case("small_datasets"), count_(count), data_(size, 4.5)
+            {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                for (std::size_t i = 0; i < count_; ++i)
+                    ar["/small/" + alps::cast<std::string>(i % 16) + "/" + alps::cast<std::string>(i)] << data_;
+                bytes = count_ * data_.size() * sizeof(double);
+                ops = count_;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                std::vector<double> data;
+                for (std::size_t i = 0; i < count_; ++i)
+                    ar["/small/" + alps::cast<std::string>(i % 16) + "/" + alps::cast<std::string>(i)] >> data;
+                bytes = count_ * data_.size() * sizeof(double);
+                ops = count_;
+            }
+        private:
+            std::size_t count_;
+            std::vector<double> data_;
+    };
+
+    /// `write()` creates the group, `read()` measures listing its children
+    class group_listing : public benchmark_case {
+        public:
+            group_listing(std::size_t children, std::size_t listings)
+                : benchmark_case("group_listing"), children_(children), listings_(listings)
+            {}
+            void write(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                for (std::size_t i = 0; i < children_; ++i)
+                    ar["/listing/" + alps::cast<std::string>(i)] << static_cast<int>(i);
+                bytes = children_ * sizeof(int);
+                ops = children_;
+            }
+            void read(alps::hdf5::archive & ar, std::size_t & bytes, std::size_t & ops) const {
+                bytes = 0;
+                for (std::size_t i = 0; i < listings_; ++i)
+                    if (ar.list_children("/listing").size() != children_)
+                        throw std::runtime_error("unexpected number of children in /listing");
+                ops = listings_;
+            }
+        private:
+            std::size_t children_, listings_;
+    };
+
+    // best of `repetitions` runs, each on a fresh file
+    std::pair<measurement, measurement> run(benchmark_case const & bench, std::string const & mode, std::size_t repetitions) {
+        measurement best_write = { 0., 0, 0 }, best_read = { 0., 0, 0 };
+        for (std::size_t rep = 0; rep < repetitions; ++rep) {
+            alps::testing::unique_file ufile("hdf5_benchmark.h5.", alps::testing::unique_file::REMOVE_NOW);
+            measurement current;
+            {
+                clock_type::time_point start = clock_type::now();
+                alps::hdf5::archive ar(ufile.name(), "w" + mode);
+                bench.write(ar, current.bytes, current.ops);
+                ar.close();
+                current.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+                if (rep == 0 || current.seconds < best_write.seconds)
+                    best_write = current;
+            }
+            {
+                clock_type::time_point start = clock_type::now();
+                alps::hdf5::archive ar(ufile.name(), "r" + mode);
+                bench.read(ar, current.bytes, current.ops);
+                ar.close();
+                current.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+                if (rep == 0 || current.seconds < best_read.seconds)
+                    best_read = current;
+            }
+        }
+        return std::make_pair(best_write, best_read);
+    }
+
+    void report(std::string const & name, std::string const & storage, std::string const & op, measurement const & m) {
+        double seconds = std::max(m.seconds, 1e-9);
+        std::cout << std::left << std::setw(16) << name
+                  << std::setw(12) << storage
+                  << std::setw(7) << op
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << m.bytes / seconds / (1 << 20)
+                  << std::setw(14) << m.ops / seconds
+                  << std::endl;
+    }
+}
+
+int main(int argc, char ** argv) {
+    std::size_t scale = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 1;
+    std::size_t repetitions = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 3;
+
+    std::vector<benchmark_case *> cases;
+    cases.push_back(new scalars(1000 * scale));
+    cases.push_back(new attributes(500 * scale));
+    cases.push_back(new contiguous_vector((1 << 20) * scale));
+    cases.push_back(new nested_vector(1024 * scale, 256));
+    cases.push_back(new multi_array(1024 * scale, 256));
+    cases.push_back(new complex_vector((1 << 19) * scale));
+    cases.push_back(new small_datasets(1000 * scale, 16));
+    cases.push_back(new group_listing(1000 * scale, 100));
+
+    std::vector<std::pair<std::string, std::string> > storages;
+    storages.push_back(std::make_pair("disk", ""));
+    storages.push_back(std::make_pair("compressed", "c"));
+    storages.push_back(std::make_pair("memory", "m"));
+
+    std::cout << std::left << std::setw(16) << "case"
+              << std::setw(12) << "storage"
+              << std::setw(7) << "op"
+              << std::right << std::setw(12) << "MB/s"
+              << std::setw(14) << "ops/s"
+              << std::endl;
+    int status = EXIT_SUCCESS;
+    for (std::vector<benchmark_case *>::const_iterator it = cases.begin(); it != cases.end(); ++it) {
+        for (std::vector<std::pair<std::string, std::string> >::const_iterator jt = storages.begin(); jt != storages.end(); ++jt)
+            try {
+                std::pair<measurement, measurement> result = run(**it, jt->second, repetitions);
+                report((*it)->name(), jt->first, "write", result.first);
+                report((*it)->name(), jt->first, "read", result.second);
+            } catch (std::exception const & ex) {
+                std::cerr << (*it)->name() << " (" << jt->first << ") failed: " << ex.what() << std::endl;
+                status = EXIT_FAILURE;
+            }
+        delete *it;
+    }
+    return status;
+}
@@ -8,6 +8,7 @@
 #include <alps/hdf5/archive.hpp>
 #include <alps/hdf5/complex.hpp>
 #include <alps/hdf5/vector.hpp>
+#include <alps/testing/unique_file.hpp>
 #include <vector>
 #include <iostream>
 #include <algorithm>
@@ -61,3 +62,23 @@ TEST(hdf5_complex, TestingIoOfComplexVars){
     }
     
 }
+
+TEST(hdf5_complex, ComplexFlagFollowsOverwrite){
+    alps::testing::unique_file ufile("hdf5_complex_overwrite.h5.", alps::testing::unique_file::REMOVE_NOW);
+    alps::hdf5::archive ar(ufile.name(), "w");
+
+    ar << alps::make_pvp("/data/vec", std::vector<double>(3, 1.));
+    EXPECT_FALSE(ar.is_complex("/data/vec"));
+    EXPECT_FALSE(ar.is_complex("/data"));
+
+    ar << alps::make_pvp("/data/vec", std::vector<std::complex<double> >(3, std::complex<double>(1., 2.)));
+    EXPECT_TRUE(ar.is_complex("/data/vec"));
+    EXPECT_TRUE(ar.is_complex("/data"));
+
+    ar.delete_data("/data/vec");
+    ar << alps::make_pvp("/data/vec", std::vector<double>(3, 1.));
+    EXPECT_FALSE(ar.is_complex("/data"));
+
+    std::vector<std::complex<double> > cplx;
+    EXPECT_THROW(ar >> alps::make_pvp("/data/vec", cplx), alps::hdf5::archive_error);
+}
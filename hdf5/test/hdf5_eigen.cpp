@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/eigen.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/hdf5/complex.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+#include <complex>
+
+#include "gtest/gtest.h"
+
+class hdf5_eigen : public ::testing::Test {
+  protected:
+    alps::testing::unique_file ufile_;
+    hdf5_eigen() : ufile_("hdf5_eigen.h5.", alps::testing::unique_file::REMOVE_NOW) {}
+};
+
+TEST_F(hdf5_eigen, DynamicColMajor) {
+    Eigen::MatrixXd m(3, 4);
+    for (int i = 0; i < m.rows(); ++i)
+        for (int j = 0; j < m.cols(); ++j)
+            m(i, j) = 10 * i + j;
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/m"] << m;
+        ar["/a"] << Eigen::ArrayXXd(m.array());
+        ar["/map"] << Eigen::Map<Eigen::MatrixXd const>(m.data(), m.rows(), m.cols());
+        std::vector<std::size_t> extent = ar.extent("/m");
+        ASSERT_EQ(2u, extent.size());
+        EXPECT_EQ(3u, extent[0]);
+        EXPECT_EQ(4u, extent[1]);
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    Eigen::MatrixXd m_col;
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> m_row;
+    ar["/m"] >> m_col;
+    ar["/m"] >> m_row;
+    EXPECT_TRUE(m == m_col);
+    EXPECT_TRUE(m == m_row);
+    ar["/a"] >> m_col;
+    EXPECT_TRUE(m == m_col);
+    ar["/map"] >> m_row;
+    EXPECT_TRUE(m == m_row);
+}
+
+TEST_F(hdf5_eigen, RowMajorMatchesMultiArrayLayout) {
+    Eigen::Matrix<double, 2, 3, Eigen::RowMajor> m;
+    m << 1, 2, 3, 4, 5, 6;
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/m"] << m;
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<std::vector<double> > v;
+    ar["/m"] >> v;
+    ASSERT_EQ(2u, v.size());
+    EXPECT_EQ(3., v[0][2]);
+    EXPECT_EQ(4., v[1][0]);
+    Eigen::Matrix<double, 2, 3> fixed;
+    ar["/m"] >> fixed;
+    EXPECT_TRUE(m == fixed);
+    Eigen::Matrix<double, 3, 2> wrong;
+    EXPECT_THROW(ar["/m"] >> wrong, alps::hdf5::archive_error);
+}
+
+TEST_F(hdf5_eigen, VectorsAreOneDimensional) {
+    Eigen::VectorXd v = Eigen::VectorXd::LinSpaced(5, 0., 4.);
+    Eigen::RowVector3d r(1., 2., 3.);
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/v"] << v;
+        ar["/r"] << r;
+        EXPECT_EQ(1u, ar.dimensions("/v"));
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<double> std_v;
+    ar["/v"] >> std_v;
+    ASSERT_EQ(5u, std_v.size());
+    EXPECT_EQ(4., std_v[4]);
+    Eigen::ArrayXd a;
+    ar["/r"] >> a;
+    EXPECT_TRUE(r.transpose() == a.matrix());
+}
+
+TEST_F(hdf5_eigen, Complex) {
+    Eigen::MatrixXcd m(2, 2);
+    m << std::complex<double>(1, 2), std::complex<double>(3, 4),
+         std::complex<double>(5, 6), std::complex<double>(7, 8);
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/m"] << m;
+        EXPECT_TRUE(ar.is_complex("/m"));
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    Eigen::MatrixXcd m_read;
+    ar["/m"] >> m_read;
+    EXPECT_TRUE(m == m_read);
+    Eigen::MatrixXd real;
+    EXPECT_THROW(ar["/m"] >> real, alps::hdf5::archive_error);
+}
+
+TEST_F(hdf5_eigen, MapWritesIntoPreallocatedMemory) {
+    Eigen::Matrix3d m = Eigen::Matrix3d::Random();
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/m"] << m;
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<double> buffer(9, 0.);
+    Eigen::Map<Eigen::Matrix3d> map(&buffer[0]);
+    ar["/m"] >> map;
+    EXPECT_TRUE(m == map);
+    Eigen::Map<Eigen::MatrixXd> small(&buffer[0], 2, 2);
+    EXPECT_THROW(ar["/m"] >> small, alps::hdf5::archive_error);
+}
+
+TEST_F(hdf5_eigen, VectorOfEigenVectors) {
+    std::vector<Eigen::VectorXd> v(3, Eigen::VectorXd::Zero(4));
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i](i) = i + 1.;
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/v"] << v;
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<Eigen::VectorXd> v_read;
+    ar["/v"] >> v_read;
+    ASSERT_EQ(v.size(), v_read.size());
+    for (std::size_t i = 0; i < v.size(); ++i)
+        EXPECT_TRUE(v[i] == v_read[i]);
+}
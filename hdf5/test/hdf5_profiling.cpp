@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5.hpp>
+#include <alps/hdf5/profiling.hpp>
+
+#include <gtest/gtest.h>
+#include <alps/testing/unique_file.hpp>
+
+namespace ap=alps::profiling;
+
+TEST(Hdf5ProfilingTest, SaveLoad) {
+    ap::reset();
+    ap::enable(true);
+    for (int i=0; i<3; ++i) {
+        ap::scoped_timer timer("mc/update"); // the name is not a path
+    }
+    ap::count("items", 2.5);
+    ap::disable();
+    const ap::report rep=ap::collect();
+    ap::reset();
+
+    alps::testing::unique_file ufile("hdf5_profiling.h5.", alps::testing::unique_file::REMOVE_NOW);
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        ar["/profile"] << rep;
+        ar["/empty"] << ap::report();
+    }
+
+    ap::report loaded, empty;
+    {
+        alps::hdf5::archive ar(ufile.name(), "r");
+        EXPECT_TRUE(ar.is_group("/profile/timers"));
+        ar["/profile"] >> loaded;
+        ar["/empty"] >> empty;
+    }
+    EXPECT_TRUE(empty.empty());
+
+    ASSERT_EQ(1u, loaded.timers.size());
+    const ap::statistics& update=loaded.timers["mc/update"];
+    EXPECT_EQ(3u, update.count);
+    EXPECT_EQ(rep.timers.find("mc/update")->second.total, update.total);
+    EXPECT_EQ(rep.timers.find("mc/update")->second.max, update.max);
+    EXPECT_EQ(2.5, loaded.counters["items"].total);
+
+    ASSERT_EQ(3u, loaded.events.size());
+    for (std::size_t i=0; i<3; ++i) {
+        EXPECT_EQ("mc/update", loaded.events[i].name);
+        EXPECT_EQ(rep.events[i].begin, loaded.events[i].begin);
+        EXPECT_EQ(rep.events[i].duration, loaded.events[i].duration);
+    }
+}
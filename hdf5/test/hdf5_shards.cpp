@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/hdf5/complex.hpp>
+#include <alps/hdf5/multi_array.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <vector>
+#include <complex>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+class hdf5_shards : public ::testing::Test {
+  protected:
+    alps::testing::unique_file master_, shard0_, shard1_, shard2_;
+    std::vector<std::string> shards_;
+
+    hdf5_shards()
+        : master_("hdf5_shards.master.h5.", alps::testing::unique_file::REMOVE_NOW)
+        , shard0_("hdf5_shards.0.h5.", alps::testing::unique_file::REMOVE_NOW)
+        , shard1_("hdf5_shards.1.h5.", alps::testing::unique_file::REMOVE_NOW)
+        , shard2_("hdf5_shards.2.h5.", alps::testing::unique_file::REMOVE_NOW)
+    {
+        shards_.push_back(shard0_.name());
+        shards_.push_back(shard1_.name());
+        shards_.push_back(shard2_.name());
+        for (int rank = 0; rank < 3; ++rank) {
+            alps::hdf5::archive ar(shards_[rank], "w");
+            ar["/sweeps"] << 10 * rank;
+            ar["/data/ragged"] << std::vector<double>(rank + 1, rank);
+            ar["/data/ragged/@unit"] << std::string("s");
+            boost::multi_array<int, 2> block(boost::extents[2][3]);
+            std::fill(block.data(), block.data() + block.num_elements(), rank);
+            ar["/data/block"] << block;
+            ar["/data/complex"] << std::vector<std::complex<double> >(2, std::complex<double>(rank, -rank));
+            ar["/data/mismatch"] << std::vector<std::vector<double> >(2, std::vector<double>(rank + 1));
+            ar["/data/empty"] << std::vector<double>();
+            ar["/name"] << std::string("shard");
+            if (rank == 0)
+                ar["/data/only_first"] << 1.;
+        }
+    }
+};
+
+TEST_F(hdf5_shards, ConcatenatesAlongFirstDimension) {
+    std::vector<std::string> skipped = alps::hdf5::archive::stitch_shards(master_.name(), shards_);
+    std::sort(skipped.begin(), skipped.end());
+    ASSERT_EQ(3u, skipped.size());
+    EXPECT_EQ("/data/mismatch", skipped[0]);
+    EXPECT_EQ("/data/only_first", skipped[1]);
+    EXPECT_EQ("/name", skipped[2]);
+
+    alps::hdf5::archive ar(master_.name(), "r");
+
+    std::vector<int> sweeps;
+    ar["/sweeps"] >> sweeps;
+    ASSERT_EQ(3u, sweeps.size());
+    EXPECT_EQ(20, sweeps[2]);
+
+    std::vector<double> ragged;
+    ar["/data/ragged"] >> ragged;
+    ASSERT_EQ(6u, ragged.size());
+    EXPECT_EQ(0., ragged[0]);
+    EXPECT_EQ(1., ragged[2]);
+    EXPECT_EQ(2., ragged[5]);
+    std::string unit;
+    ar["/data/ragged/@unit"] >> unit;
+    EXPECT_EQ("s", unit);
+
+    boost::multi_array<int, 2> block;
+    ar["/data/block"] >> block;
+    ASSERT_EQ(6u, block.shape()[0]);
+    ASSERT_EQ(3u, block.shape()[1]);
+    EXPECT_EQ(1, block[2][2]);
+    EXPECT_EQ(2, block[5][0]);
+
+    EXPECT_TRUE(ar.is_complex("/data/complex"));
+    std::vector<std::complex<double> > cplx;
+    ar["/data/complex"] >> cplx;
+    ASSERT_EQ(6u, cplx.size());
+    EXPECT_EQ(std::complex<double>(2., -2.), cplx[4]);
+
+    EXPECT_TRUE(ar.is_null("/data/empty"));
+    EXPECT_FALSE(ar.is_data("/name"));
+}
+
+TEST_F(hdf5_shards, MissingShard) {
+    shards_.push_back(shards_.back() + ".missing");
+    EXPECT_THROW(alps::hdf5::archive::stitch_shards(master_.name(), shards_), alps::hdf5::archive_error);
+    EXPECT_THROW(alps::hdf5::archive::stitch_shards(master_.name(), std::vector<std::string>()), alps::hdf5::archive_error);
+}
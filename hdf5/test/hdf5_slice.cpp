@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/hdf5/complex.hpp>
+#include <alps/hdf5/multi_array.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <vector>
+#include <complex>
+
+#include "gtest/gtest.h"
+
+using alps::hdf5::range;
+
+class hdf5_slice : public ::testing::Test {
+  protected:
+    alps::testing::unique_file ufile_;
+    boost::multi_array<double, 3> data_;
+
+    hdf5_slice() : ufile_("hdf5_slice.h5.", alps::testing::unique_file::REMOVE_NOW), data_(boost::extents[4][5][6]) {
+        for (std::size_t i = 0; i < 4; ++i)
+            for (std::size_t j = 0; j < 5; ++j)
+                for (std::size_t k = 0; k < 6; ++k)
+                    data_[i][j][k] = 100. * i + 10. * j + k;
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/data"] << data_;
+        ar["/cplx"] << std::vector<std::complex<double> >(10, std::complex<double>(1., -1.));
+    }
+};
+
+TEST_F(hdf5_slice, MultiArrayBlock) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<range> ranges;
+    ranges.push_back(range(1, 3));
+    ranges.push_back(range());
+    ranges.push_back(range(4));
+    boost::multi_array<double, 2> block;
+    ar["/data"].slice(ranges) >> block;
+    ASSERT_EQ(2u, block.shape()[0]);
+    ASSERT_EQ(5u, block.shape()[1]);
+    for (std::size_t i = 0; i < 2; ++i)
+        for (std::size_t j = 0; j < 5; ++j)
+            EXPECT_EQ(data_[i + 1][j][4], block[i][j]);
+
+    boost::multi_array<double, 3> wrong_rank;
+    EXPECT_THROW(ar["/data"].slice(ranges) >> wrong_rank, alps::hdf5::archive_error);
+}
+
+TEST_F(hdf5_slice, StridedVector) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<range> ranges;
+    ranges.push_back(range(2));
+    ranges.push_back(range(3));
+    ranges.push_back(range(1, 6, 2));
+    std::vector<double> v;
+    ar["/data"].slice(ranges) >> v;
+    ASSERT_EQ(3u, v.size());
+    for (std::size_t k = 0; k < v.size(); ++k)
+        EXPECT_EQ(data_[2][3][1 + 2 * k], v[k]);
+}
+
+TEST_F(hdf5_slice, TrailingDimensionsSelectAll) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<range> ranges(1, range(0, 4, 3));
+    boost::multi_array<int, 3> block;
+    ar["/data"].slice(ranges) >> block;
+    ASSERT_EQ(2u, block.shape()[0]);
+    EXPECT_EQ(static_cast<int>(data_[3][4][5]), block[1][4][5]);
+}
+
+TEST_F(hdf5_slice, Complex) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<range> ranges(1, range(2, 5));
+    std::vector<std::complex<double> > v;
+    ar["/cplx"].slice(ranges) >> v;
+    ASSERT_EQ(3u, v.size());
+    EXPECT_EQ(std::complex<double>(1., -1.), v[2]);
+
+    ranges.push_back(range(0));
+    EXPECT_THROW(ar["/cplx"].slice(ranges) >> v, alps::hdf5::archive_error);
+}
+
+TEST_F(hdf5_slice, OutOfBounds) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<double> v;
+    EXPECT_THROW(ar["/data"].slice(std::vector<range>(1, range(4))) >> v, alps::hdf5::archive_error);
+    EXPECT_THROW(ar["/data"].slice(std::vector<range>(1, range(2, 7))) >> v, alps::hdf5::archive_error);
+    EXPECT_THROW(ar["/data"].slice(std::vector<range>(4, range())) >> v, alps::hdf5::archive_error);
+}
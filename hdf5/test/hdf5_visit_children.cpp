@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/hdf5/complex.hpp>
+#include <alps/utilities/cast.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <vector>
+#include <complex>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+namespace {
+    struct recorder {
+        recorder(std::vector<std::string> & names, std::vector<alps::hdf5::archive::child_type> & types, std::size_t limit)
+            : names_(names), types_(types), limit_(limit)
+        {}
+
+        bool operator()(std::string const & name, alps::hdf5::archive::child_type type) {
+            names_.push_back(name);
+            types_.push_back(type);
+            return names_.size() < limit_;
+        }
+
+        std::vector<std::string> & names_;
+        std::vector<alps::hdf5::archive::child_type> & types_;
+        std::size_t limit_;
+    };
+
+    bool throwing_visitor(std::string const &, alps::hdf5::archive::child_type) {
+        throw std::runtime_error("stop");
+    }
+}
+
+class hdf5_visit_children : public ::testing::Test {
+  protected:
+    alps::testing::unique_file ufile_;
+
+    hdf5_visit_children() : ufile_("hdf5_visit_children.h5.", alps::testing::unique_file::REMOVE_NOW) {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        ar["/group/a"] << 1;
+        ar["/group/b/c"] << 2.;
+        ar["/group/d"] << std::vector<double>(3, 1.);
+    }
+};
+
+TEST_F(hdf5_visit_children, TypesInNameOrder) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<std::string> names;
+    std::vector<alps::hdf5::archive::child_type> types;
+    ar.visit_children("/group", recorder(names, types, 10));
+    ASSERT_EQ(3u, names.size());
+    EXPECT_EQ("a", names[0]);
+    EXPECT_EQ("b", names[1]);
+    EXPECT_EQ("d", names[2]);
+    EXPECT_EQ(alps::hdf5::archive::DATA, types[0]);
+    EXPECT_EQ(alps::hdf5::archive::GROUP, types[1]);
+    EXPECT_EQ(alps::hdf5::archive::DATA, types[2]);
+    EXPECT_TRUE(names == ar.list_children("/group"));
+}
+
+TEST_F(hdf5_visit_children, StopsEarly) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<std::string> names;
+    std::vector<alps::hdf5::archive::child_type> types;
+    ar.set_context("/group");
+    ar.visit_children("", recorder(names, types, 2));
+    ASSERT_EQ(2u, names.size());
+    EXPECT_EQ("b", names[1]);
+}
+
+TEST_F(hdf5_visit_children, Errors) {
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    EXPECT_THROW(ar.visit_children("/group", throwing_visitor), std::runtime_error);
+    EXPECT_THROW(ar.visit_children("/group/a", throwing_visitor), alps::hdf5::path_not_found);
+    EXPECT_THROW(ar.visit_children("/group@attr", throwing_visitor), alps::hdf5::invalid_path);
+    // the archive is still usable after an exception left the traversal
+    int a;
+    ar["/group/a"] >> a;
+    EXPECT_EQ(1, a);
+}
+
+TEST_F(hdf5_visit_children, VectorFromGroup) {
+    {
+        alps::hdf5::archive ar(ufile_.name(), "w");
+        for (int i = 0; i < 12; ++i)
+            ar["/points/" + alps::cast<std::string>(i)] << std::complex<double>(i, -i);
+        EXPECT_TRUE(ar.is_complex("/points"));
+        EXPECT_FALSE(ar.is_complex("/group"));
+    }
+    alps::hdf5::archive ar(ufile_.name(), "r");
+    std::vector<std::complex<double> > points(20);
+    ar["/points"] >> points;
+    ASSERT_EQ(12u, points.size());
+    for (int i = 0; i < 12; ++i)
+        EXPECT_EQ(std::complex<double>(i, -i), points[i]);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+
+#ifdef ALPS_HAVE_MPI
+#include <alps/utilities/mpi.hpp>
+#endif
+
+#include <string>
+#include <vector>
+
+namespace alps {
+
+    /// Stopping policy: the run ends once the errors of named observables reach their targets
+    /** The errors are estimated from a non-destructive snapshot of the
+        accumulators (`mean()` and `error()` of the binning analysis), so the
+        targeted observables must be accumulated with an error estimate
+        (e.g. `FullBinningAccumulator`) and hold `double`-convertible scalars
+        or `std::vector<double>`.  A vector observable meets its target when
+        every component does.
+
+        Progress is reported like `mcbase::fraction_completed()`: as the
+        error scales as `1/sqrt(N)`, `(target/error)^2` estimates the
+        fraction of the required samples already taken.  The progress of a
+        set of targets is the smallest one and reaches 1 when all are met.
+
+        Across processes, the local statistics are packed into a single
+        buffer of `[N, N*mean_i, N^2*error_i^2, ...]`, which is summed by
+        one reduction; the combined error `sqrt(sum N^2 error^2)/sum N`
+        assumes independent processes.
+     */
+    class error_targets {
+        public:
+            /// Interpretation of the target
+            enum target_kind {
+                absolute,   ///< `error <= target`
+                relative    ///< `error <= target*|mean|`
+            };
+
+            error_targets();
+
+            /// Adds a target for the observable `name`
+            error_targets & add(std::string const & name, double target, target_kind kind = absolute);
+
+            /// Number of targets
+            std::size_t size() const { return targets_.size(); }
+
+            /// Returns `true` if there are no targets (the policy never stops a run)
+            bool empty() const { return targets_.empty(); }
+
+            /// Progress of the local measurements towards the targets, in `[0,1]`
+            double progress(alps::accumulators::accumulator_set const & measurements);
+
+#ifdef ALPS_HAVE_MPI
+            /// Progress of the measurements combined over `comm` (collective)
+            double progress(alps::accumulators::accumulator_set const & measurements,
+                            alps::mpi::communicator const & comm);
+
+            /// Agrees on the number of components of each observable over `comm`
+            /** Collective; only communicates until every observable has been
+                measured somewhere, so that all processes pack buffers of
+                equal length afterwards. */
+            void synchronize(alps::accumulators::accumulator_set const & measurements,
+                             alps::mpi::communicator const & comm);
+#endif
+
+            /// Appends the packed local statistics of all targets to `buffer`
+            void pack(alps::accumulators::accumulator_set const & measurements,
+                      std::vector<double> & buffer);
+
+            /// Evaluates the progress from packed (and possibly reduced) statistics starting at `buffer[offset]`
+            double progress(std::vector<double> const & buffer, std::size_t offset = 0) const;
+
+        private:
+            struct target {
+                std::string name;
+                double value;
+                target_kind kind;
+                std::size_t size;   // number of components, 0 while unknown
+            };
+
+            void update_sizes(alps::accumulators::accumulator_set const & measurements);
+
+            std::vector<target> targets_;
+            bool sizes_agreed_;
+    };
+
+}
@@ -15,6 +15,7 @@
 
 #include <alps/accumulators/mpi.hpp>
 #include <alps/mc/check_schedule.hpp>
+#include <alps/utilities/profiling.hpp>
 
 namespace alps {
 
@@ -48,9 +49,16 @@ namespace alps {
             bool run(boost::function<bool ()> const & stop_callback) {
                 bool done = false, stopped = false;
                 do {
-                    this->update();
-                    this->measure();
+                    {
+                        ALPS_PROFILE_SCOPE("mc.update");
+                        this->update();
+                    }
+                    {
+                        ALPS_PROFILE_SCOPE("mc.measure");
+                        this->measure();
+                    }
                     if (stopped || schedule_checker.pending()) {
+                        ALPS_PROFILE_SCOPE("mc.check");
                         stopped = stop_callback(); 
                         double local_fraction = stopped ? 1. : Base::fraction_completed();
                         schedule_checker.update(fraction = alps::mpi::all_reduce(communicator, local_fraction, std::plus<double>()));
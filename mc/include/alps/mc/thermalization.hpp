@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <alps/config.hpp>
+#include <alps/accumulators.hpp>
+#include <alps/hdf5/archive.hpp>
+
+#include <string>
+#include <vector>
+
+namespace alps {
+
+    /// Detects the end of the warm-up from the time series of watched observables
+    /** While warming up, the driver measures as usual and passes the
+        measurements to `observe()` after each sweep; the latest sample of
+        every watched observable is recovered from the running sums of its
+        accumulator and put into batches of `batch_size` sweeps.  Batches are
+        kept in a window of at most `max_batches`; when the window is full,
+        adjacent batches are merged and the batch size doubles.
+
+        The test is MSER (marginal standard error rule): the truncation
+        point `d` minimizing `S^2(d)/(m-d)^2` over the batch means
+        `b_{d+1} .. b_m` is determined for every component, and the warm-up
+        is over once it lies in the first half of the window for all of
+        them.  The driver then discards the warm-up data by resetting the
+        measurements, and `detected_sweeps()` records where the observables
+        had equilibrated.
+
+        Detection is disabled (and the simulation thermalized from the
+        start) unless observables are watched.
+     */
+    class thermalization_detector {
+        public:
+            /// Constructs the detector
+            /** @param min_batches minimum number of batches before deciding
+                @param max_batches size of the window of batches (even)
+                @param batch_size initial number of sweeps per batch
+             */
+            thermalization_detector(std::size_t min_batches = 20,
+                                    std::size_t max_batches = 1024,
+                                    std::size_t batch_size = 5);
+
+            /// Adds an observable (scalar or `std::vector<double>`) to the ones monitored
+            thermalization_detector & watch(std::string const & name);
+
+            /// Returns `true` if observables are watched
+            bool enabled() const { return !observables_.empty(); }
+
+            /// Returns `true` once the warm-up is over (always if disabled)
+            bool thermalized() const { return thermalized_ || !enabled(); }
+
+            /// Records the latest samples of the watched observables; call once per warm-up sweep
+            void observe(alps::accumulators::accumulator_set const & measurements);
+
+            /// Local decision: returns `true` if the data seen so far are past the warm-up
+            bool ready() const;
+
+            /// Ends the warm-up
+            void finish();
+
+            /// Number of warm-up sweeps observed
+            std::size_t sweeps() const { return sweeps_; }
+
+            /// Sweep after which the watched observables are equilibrated (valid after `finish()`)
+            std::size_t detected_sweeps() const { return detected_sweeps_; }
+
+            /// Returns the MSER truncation point of the series, considering tails of at least `min_tail` entries
+            static std::size_t mser_truncation(std::vector<double> const & series, std::size_t min_tail = 5);
+
+            void save(alps::hdf5::archive & ar) const;
+            void load(alps::hdf5::archive & ar);
+
+        private:
+            struct observable {
+                std::string name;
+                int kind;                       // 0: unknown, 1: scalar, 2: vector
+                boost::uint64_t count;          // count of the accumulator at the last sample
+                std::vector<double> sum;        // running sums at the last sample
+                std::size_t batch_size;         // samples per batch
+                std::size_t in_batch;           // samples in the current batch
+                std::vector<double> partial;    // sums of the current batch
+                std::vector<std::vector<double> > batches;  // batch means, per component
+            };
+
+            void add_sample(observable & obs, std::vector<double> const & sum, boost::uint64_t count);
+            std::size_t truncation() const;
+
+            std::size_t min_batches_;
+            std::size_t max_batches_;
+            std::size_t batch_size_;
+            std::vector<observable> observables_;
+            std::size_t sweeps_;
+            std::size_t detected_sweeps_;
+            bool thermalized_;
+    };
+
+}
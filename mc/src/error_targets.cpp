@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/error_targets.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace alps {
+
+    namespace {
+        typedef alps::accumulators::accumulator_wrapper accumulator_type;
+
+        /// Takes the mean and error of the accumulator without finalizing it
+        void snapshot(accumulator_type const & acc, std::vector<double> & mean, std::vector<double> & error) {
+            bool scalar = true;
+            try {
+                mean.assign(1, acc.mean<double>());
+            } catch (std::logic_error const &) {
+                // not convertible to a scalar: try a vector observable
+                scalar = false;
+            }
+            if (scalar) {
+                error.assign(1, acc.error<double>());
+            } else {
+                mean = acc.mean<std::vector<double> >();
+                error = acc.error<std::vector<double> >();
+            }
+        }
+
+        /// Fraction of the samples needed to reach `target`, given the current `error`
+        double component_progress(double target, double error) {
+            if (error == 0.)
+                return 1.;
+            if (!(error < HUGE_VAL))    // also catches NaN from too few samples
+                return 0.;
+            double ratio = target / error;
+            return std::min(1., ratio * ratio);
+        }
+    }
+
+    error_targets::error_targets()
+        : targets_()
+        , sizes_agreed_(false)
+    {}
+
+    error_targets & error_targets::add(std::string const & name, double value, target_kind kind) {
+        if (!(value > 0.))
+            throw std::invalid_argument("Error target for " + name + " must be positive");
+        target t = { name, value, kind, 0 };
+        targets_.push_back(t);
+        sizes_agreed_ = false;
+        return *this;
+    }
+
+    void error_targets::update_sizes(alps::accumulators::accumulator_set const & measurements) {
+        std::vector<double> mean, error;
+        for (std::vector<target>::iterator it = targets_.begin(); it != targets_.end(); ++it) {
+            if (it->size != 0)
+                continue;
+            accumulator_type const & acc = measurements[it->name];
+            if (acc.count() == 0)
+                continue;
+            snapshot(acc, mean, error);
+            it->size = mean.size();
+        }
+    }
+
+    void error_targets::pack(alps::accumulators::accumulator_set const & measurements, std::vector<double> & buffer) {
+        update_sizes(measurements);
+        std::vector<double> mean, error;
+        for (std::vector<target>::const_iterator it = targets_.begin(); it != targets_.end(); ++it) {
+            accumulator_type const & acc = measurements[it->name];
+            const double n = acc.count();
+            buffer.push_back(n);
+            if (n == 0) {
+                buffer.resize(buffer.size() + 2 * it->size, 0.);
+                continue;
+            }
+            snapshot(acc, mean, error);
+            if (mean.size() != it->size)
+                throw std::runtime_error("Observable " + it->name + " changed its size");
+            for (std::size_t i = 0; i < it->size; ++i) {
+                buffer.push_back(n * mean[i]);
+                buffer.push_back(n * n * error[i] * error[i]);
+            }
+        }
+    }
+
+    double error_targets::progress(std::vector<double> const & buffer, std::size_t offset) const {
+        if (targets_.empty())
+            return 0.;
+        double result = 1.;
+        std::vector<double>::const_iterator it = buffer.begin() + offset;
+        for (std::vector<target>::const_iterator t = targets_.begin(); t != targets_.end(); ++t) {
+            const double n = *it++;
+            if (n == 0 || t->size == 0) {
+                result = 0.;
+                it += 2 * t->size;
+                continue;
+            }
+            for (std::size_t i = 0; i < t->size; ++i) {
+                const double mean = *it++ / n;
+                const double error = std::sqrt(*it++) / n;
+                const double goal = (t->kind == relative) ? t->value * std::abs(mean) : t->value;
+                result = std::min(result, component_progress(goal, error));
+            }
+        }
+        return result;
+    }
+
+    double error_targets::progress(alps::accumulators::accumulator_set const & measurements) {
+        std::vector<double> buffer;
+        pack(measurements, buffer);
+        return progress(buffer);
+    }
+
+#ifdef ALPS_HAVE_MPI
+    void error_targets::synchronize(alps::accumulators::accumulator_set const & measurements,
+                                    alps::mpi::communicator const & comm) {
+        // `sizes_agreed_` follows from reduced data, hence is the same on all processes
+        if (sizes_agreed_ || targets_.empty())
+            return;
+        update_sizes(measurements);
+        std::vector<unsigned long> local(targets_.size()), global(targets_.size());
+        for (std::size_t i = 0; i < targets_.size(); ++i)
+            local[i] = targets_[i].size;
+        alps::mpi::all_reduce(comm, &local[0], local.size(), &global[0], alps::mpi::maximum<unsigned long>());
+
+        sizes_agreed_ = true;
+        for (std::size_t i = 0; i < targets_.size(); ++i) {
+            if (targets_[i].size != 0 && targets_[i].size != global[i])
+                throw std::runtime_error("Observable " + targets_[i].name + " has different sizes on different processes");
+            targets_[i].size = global[i];
+            sizes_agreed_ = sizes_agreed_ && global[i] != 0;
+        }
+    }
+
+    double error_targets::progress(alps::accumulators::accumulator_set const & measurements,
+                                   alps::mpi::communicator const & comm) {
+        if (targets_.empty())
+            return 0.;
+        synchronize(measurements, comm);
+        std::vector<double> local, global;
+        pack(measurements, local);
+        global.resize(local.size());
+        alps::mpi::all_reduce(comm, &local[0], local.size(), &global[0], std::plus<double>());
+        return progress(global);
+    }
+#endif
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include <alps/utilities/signal.hpp>
+#include <alps/utilities/profiling.hpp>
 #include <alps/mc/mcbase.hpp>
 
 namespace alps {
@@ -33,8 +34,14 @@ namespace alps {
     bool mcbase::run(boost::function<bool ()> const & stop_callback) {
         bool stopped = false;
         while(!(stopped = stop_callback()) && fraction_completed() < 1.) {
-            update();
-            measure();
+            {
+                ALPS_PROFILE_SCOPE("mc.update");
+                update();
+            }
+            {
+                ALPS_PROFILE_SCOPE("mc.measure");
+                measure();
+            }
         }
         return !stopped;
     }
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/thermalization.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace alps {
+
+    thermalization_detector::thermalization_detector(std::size_t min_batches,
+                                                     std::size_t max_batches,
+                                                     std::size_t batch_size)
+        : min_batches_(min_batches)
+        , max_batches_(max_batches)
+        , batch_size_(batch_size)
+        , observables_()
+        , sweeps_(0)
+        , detected_sweeps_(0)
+        , thermalized_(false)
+    {
+        if (max_batches_ < 2 || max_batches_ % 2 != 0 || min_batches_ > max_batches_ || batch_size_ == 0)
+            throw std::invalid_argument("Invalid window for thermalization detection");
+    }
+
+    thermalization_detector & thermalization_detector::watch(std::string const & name) {
+        observable obs;
+        obs.name = name;
+        obs.kind = 0;
+        obs.count = 0;
+        obs.batch_size = batch_size_;
+        obs.in_batch = 0;
+        observables_.push_back(obs);
+        return *this;
+    }
+
+    void thermalization_detector::observe(alps::accumulators::accumulator_set const & measurements) {
+        ++sweeps_;
+        std::vector<double> sum;
+        for (std::vector<observable>::iterator it = observables_.begin(); it != observables_.end(); ++it) {
+            alps::accumulators::accumulator_wrapper const & acc = measurements[it->name];
+            const boost::uint64_t count = acc.count();
+            if (count == it->count)
+                continue;
+            if (it->kind == 0) {
+                try {
+                    acc.mean<double>();
+                    it->kind = 1;
+                } catch (std::logic_error const &) {
+                    it->kind = 2;
+                }
+            }
+            if (count == 0)
+                sum.clear();
+            else if (it->kind == 1)
+                sum.assign(1, acc.mean<double>());
+            else
+                sum = acc.mean<std::vector<double> >();
+            for (std::vector<double>::iterator s = sum.begin(); s != sum.end(); ++s)
+                *s *= count;
+            add_sample(*it, sum, count);
+        }
+    }
+
+    void thermalization_detector::add_sample(observable & obs, std::vector<double> const & sum, boost::uint64_t count) {
+        if (count < obs.count || sum.size() != obs.sum.size()) {
+            // first sample, or the accumulator was reset: start from scratch
+            obs.sum.assign(sum.size(), 0.);
+            obs.partial.assign(sum.size(), 0.);
+            obs.batches.assign(sum.size(), std::vector<double>());
+            obs.batch_size = batch_size_;
+            obs.in_batch = 0;
+            obs.count = 0;
+        }
+        if (count == 0)
+            return;
+        // the latest sample is the increase of the running sums (or their average over several new samples)
+        const double new_samples = count - obs.count;
+        for (std::size_t i = 0; i < sum.size(); ++i)
+            obs.partial[i] += (sum[i] - obs.sum[i]) / new_samples;
+        obs.sum = sum;
+        obs.count = count;
+
+        if (++obs.in_batch < obs.batch_size)
+            return;
+        for (std::size_t i = 0; i < obs.partial.size(); ++i) {
+            obs.batches[i].push_back(obs.partial[i] / obs.batch_size);
+            obs.partial[i] = 0.;
+        }
+        obs.in_batch = 0;
+
+        if (!obs.batches.empty() && obs.batches[0].size() == max_batches_) {
+            // full window: merge adjacent batches
+            for (std::size_t i = 0; i < obs.batches.size(); ++i) {
+                std::vector<double> & b = obs.batches[i];
+                for (std::size_t j = 0; j < max_batches_ / 2; ++j)
+                    b[j] = (b[2 * j] + b[2 * j + 1]) / 2;
+                b.resize(max_batches_ / 2);
+            }
+            obs.batch_size *= 2;
+        }
+    }
+
+    std::size_t thermalization_detector::mser_truncation(std::vector<double> const & series, std::size_t min_tail) {
+        const std::size_t m = series.size();
+        if (min_tail == 0 || m < min_tail)
+            return m;
+        // accumulate the tail `series[d..m)` from the back; on ties, the earlier truncation wins
+        double s1 = 0., s2 = 0., best = 0.;
+        std::size_t best_d = m;
+        for (std::size_t d = m; d-- > 0; ) {
+            s1 += series[d];
+            s2 += series[d] * series[d];
+            const double n = m - d;
+            if (n < min_tail)
+                continue;
+            const double ss = std::max(0., s2 - s1 * s1 / n);
+            const double mser = ss / (n * n);
+            if (best_d == m || mser <= best) {
+                best = mser;
+                best_d = d;
+            }
+        }
+        return best_d;
+    }
+
+    bool thermalization_detector::ready() const {
+        if (thermalized())
+            return true;
+        for (std::vector<observable>::const_iterator it = observables_.begin(); it != observables_.end(); ++it) {
+            if (it->batches.empty() || it->batches[0].size() < min_batches_)
+                return false;
+            for (std::size_t i = 0; i < it->batches.size(); ++i) {
+                if (2 * mser_truncation(it->batches[i]) > it->batches[i].size())
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t thermalization_detector::truncation() const {
+        std::size_t result = 0;
+        for (std::vector<observable>::const_iterator it = observables_.begin(); it != observables_.end(); ++it) {
+            // the window covers the latest samples: convert the truncation point into sweeps
+            for (std::size_t i = 0; i < it->batches.size(); ++i) {
+                const std::size_t m = it->batches[i].size();
+                const std::size_t d = mser_truncation(it->batches[i]);
+                const std::size_t tail = (m - d) * it->batch_size + it->in_batch;
+                result = std::max(result, sweeps_ > tail ? sweeps_ - tail : 0);
+            }
+        }
+        return result;
+    }
+
+    void thermalization_detector::finish() {
+        if (thermalized_)
+            return;
+        detected_sweeps_ = truncation();
+        thermalized_ = true;
+        for (std::vector<observable>::iterator it = observables_.begin(); it != observables_.end(); ++it) {
+            std::vector<std::vector<double> >().swap(it->batches);
+            std::vector<double>().swap(it->partial);
+            std::vector<double>().swap(it->sum);
+        }
+    }
+
+    void thermalization_detector::save(alps::hdf5::archive & ar) const {
+        ar["thermalized"] << thermalized();
+        ar["sweeps"] << static_cast<unsigned long>(sweeps_);
+        ar["detected_sweeps"] << static_cast<unsigned long>(detected_sweeps_);
+    }
+
+    void thermalization_detector::load(alps::hdf5::archive & ar) {
+        unsigned long sweeps, detected_sweeps;
+        bool thermalized;
+        ar["thermalized"] >> thermalized;
+        ar["sweeps"] >> sweeps;
+        ar["detected_sweeps"] >> detected_sweeps;
+        sweeps_ = sweeps;
+        detected_sweeps_ = detected_sweeps;
+        // an unfinished warm-up restarts the detection from the restored state
+        thermalized_ = thermalized;
+    }
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/api.hpp>
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/error_targets.hpp>
+#include <alps/mc/stop_callback.hpp>
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Simulation to measure 1+x, with a sweep budget far beyond the targets
+class my_sim_type : public alps::mcbase {
+
+    public:
+
+        my_sim_type(parameters_type const & params, std::size_t seed_offset = 42)
+            : alps::mcbase(params, seed_offset)
+            , count(0)
+            , total_count(params["COUNT"])
+        {
+            measurements << alps::accumulators::FullBinningAccumulator<double>("SValue")
+                         << alps::accumulators::FullBinningAccumulator<std::vector<double> >("VValue");
+        }
+
+        void update() {
+            value = 1 + random();
+        };
+
+        void measure() {
+            ++count;
+            measurements["SValue"] << value;
+            measurements["VValue"] << std::vector<double>(3, 2 * value);
+        };
+
+        double fraction_completed() const {
+            return count / double(total_count);
+        }
+
+        long sweeps() const { return count; }
+
+    private:
+        long count;
+        long total_count;
+        double value;
+};
+
+TEST(error_targets, progress) {
+    alps::accumulators::accumulator_set measurements;
+    measurements << alps::accumulators::NoBinningAccumulator<double>("x")
+                 << alps::accumulators::NoBinningAccumulator<std::vector<double> >("y");
+
+    alps::error_targets targets;
+    EXPECT_TRUE(targets.empty());
+    EXPECT_EQ(0., targets.progress(measurements));
+    EXPECT_THROW(targets.add("x", 0.), std::invalid_argument);
+
+    targets.add("x", 0.1);
+    EXPECT_EQ(0., targets.progress(measurements)) << "Nothing measured yet";
+
+    for (int i = 0; i < 100; ++i) {
+        measurements["x"] << double(i % 2);
+        std::vector<double> y(2, 10.);
+        y[0] += 0.1 * (i % 2);
+        y[1] += i % 4;
+        measurements["y"] << y;
+    }
+    const double err_x = measurements["x"].error<double>();
+    EXPECT_NEAR(std::min(1., 0.01 / (err_x * err_x)), targets.progress(measurements), 1E-12);
+
+    // the worst component of a vector observable counts
+    targets.add("y", 0.001, alps::error_targets::relative);
+    EXPECT_EQ(2u, targets.size());
+    const std::vector<double> mean_y = measurements["y"].mean<std::vector<double> >();
+    const std::vector<double> err_y = measurements["y"].error<std::vector<double> >();
+    const double goal_y = 0.001 * mean_y[1];
+    EXPECT_NEAR(goal_y * goal_y / (err_y[1] * err_y[1]), targets.progress(measurements), 1E-12);
+
+    // packed statistics may follow other data of the caller
+    std::vector<double> buffer(1, -1.);
+    targets.pack(measurements, buffer);
+    EXPECT_EQ(1u + 3 + 5, buffer.size());
+    EXPECT_EQ(targets.progress(measurements), targets.progress(buffer, 1));
+}
+
+TEST(error_targets, stops_run) {
+    alps::parameters_type<my_sim_type>::type params;
+    params["COUNT"] = 1000000000L;
+    my_sim_type::define_parameters(params);
+
+    my_sim_type my_sim(params);
+    my_sim.stopping_targets()
+        .add("SValue", 0.005)
+        .add("VValue", 0.005, alps::error_targets::relative);
+
+    EXPECT_TRUE(my_sim.run(alps::simple_time_callback(60)));
+    EXPECT_LT(my_sim.sweeps(), 1000000);
+
+    alps::results_type<my_sim_type>::type results = alps::collect_results(my_sim);
+    EXPECT_LE(results["SValue"].error<double>(), 0.005);
+    const std::vector<double> mean = results["VValue"].mean<std::vector<double> >();
+    const std::vector<double> err = results["VValue"].error<std::vector<double> >();
+    ASSERT_EQ(3u, err.size());
+    for (std::size_t i = 0; i < err.size(); ++i) {
+        EXPECT_NEAR(3., mean[i], 0.1);
+        EXPECT_LE(err[i], 0.005 * mean[i]);
+    }
+}
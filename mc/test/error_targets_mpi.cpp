@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/api.hpp>
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/error_targets.hpp>
+#include <alps/mc/mpiadapter.hpp>
+#include <alps/mc/stop_callback.hpp>
+
+#include "gtest/gtest.h"
+
+// Simulation to measure 1+x, with a sweep budget far beyond the targets
+class my_sim_type : public alps::mcbase {
+
+    public:
+
+        template <typename Arg> my_sim_type(parameters_type const & params, Arg comm)
+            : alps::mcbase(params, comm)
+            , count(0)
+            , total_count(params["COUNT"])
+        {
+            measurements << alps::accumulators::FullBinningAccumulator<double>("SValue")
+                         << alps::accumulators::FullBinningAccumulator<std::vector<double> >("VValue");
+        }
+
+        void update() {
+            value = 1 + random();
+        };
+
+        void measure() {
+            ++count;
+            measurements["SValue"] << value;
+            measurements["VValue"] << std::vector<double>(3, 2 * value);
+        };
+
+        double fraction_completed() const {
+            return count / double(total_count);
+        }
+
+    private:
+        long count;
+        long total_count;
+        double value;
+};
+
+TEST(error_targets_mpi, progress) {
+    alps::mpi::communicator comm;
+
+    // only the root has measured the vector observable so far
+    alps::accumulators::accumulator_set measurements;
+    measurements << alps::accumulators::NoBinningAccumulator<std::vector<double> >("y");
+    alps::error_targets targets;
+    targets.add("y", 1.);
+    EXPECT_EQ(0., targets.progress(measurements, comm));
+
+    if (comm.rank() == 0) {
+        for (int i = 0; i < 10; ++i)
+            measurements["y"] << std::vector<double>(2, i % 2);
+    }
+    EXPECT_EQ(1., targets.progress(measurements, comm));
+
+    if (comm.rank() != 0) {
+        for (int i = 0; i < 10; ++i)
+            measurements["y"] << std::vector<double>(2, i % 2);
+    }
+    EXPECT_EQ(1., targets.progress(measurements, comm));
+}
+
+TEST(error_targets_mpi, stops_run) {
+    alps::mpi::communicator comm;
+
+    alps::mcbase::parameters_type params;
+    params["COUNT"] = 1000000000L;
+    alps::mcmpiadapter<my_sim_type>::define_parameters(params);
+    params.broadcast(comm, 0);
+
+    alps::mcmpiadapter<my_sim_type> my_sim(params, comm, alps::check_schedule(0, 1));
+    my_sim.stopping_targets()
+        .add("SValue", 0.005)
+        .add("VValue", 0.005, alps::error_targets::relative);
+
+    // the sweep budget cannot be exhausted within the time limit
+    EXPECT_TRUE(my_sim.run(alps::stop_callback(comm, 120)));
+    EXPECT_LE(1., my_sim.fraction_completed());
+
+    alps::results_type<alps::mcmpiadapter<my_sim_type> >::type results = alps::collect_results(my_sim);
+    if (comm.rank() == 0) {
+        EXPECT_NEAR(1.5, results["SValue"].mean<double>(), 0.05);
+        // binning errors of the merged data are close to the combined estimate
+        EXPECT_LE(results["SValue"].error<double>(), 0.0075);
+    }
+}
+
+int main(int argc, char** argv)
+{
+   alps::mpi::environment env(argc, argv, false);
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
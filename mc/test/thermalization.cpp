@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/mc/api.hpp>
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/thermalization.hpp>
+#include <alps/mc/stop_callback.hpp>
+
+#include <alps/testing/unique_file.hpp>
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+// Relaxes from 10 to about 1 with a time constant of `TAU` sweeps
+class my_sim_type : public alps::mcbase {
+
+    public:
+
+        static const int TAU = 200;
+
+        my_sim_type(parameters_type const & params, std::size_t seed_offset = 42)
+            : alps::mcbase(params, seed_offset)
+            , sweeps(0)
+            , count(0)
+            , total_count(params["COUNT"])
+        {
+            measurements << alps::accumulators::FullBinningAccumulator<double>("Energy")
+                         << alps::accumulators::FullBinningAccumulator<std::vector<double> >("Magnetization");
+        }
+
+        void update() {
+            ++sweeps;
+            value = 1 + 9 * std::exp(-double(sweeps) / TAU) + 0.1 * (random() - 0.5);
+        };
+
+        void measure() {
+            if (thermalization().thermalized())
+                ++count;
+            measurements["Energy"] << value;
+            measurements["Magnetization"] << std::vector<double>(2, 2 - value);
+        };
+
+        double fraction_completed() const {
+            return count / double(total_count);
+        }
+
+        long total_sweeps() const { return sweeps; }
+
+    private:
+        long sweeps;
+        long count;
+        long total_count;
+        double value;
+};
+
+TEST(thermalization, mser) {
+    std::vector<double> series;
+    for (int i = 0; i < 200; ++i)
+        series.push_back(std::exp(-i / 10.) + 0.01 * std::sin(1.3 * i));
+    const std::size_t d = alps::thermalization_detector::mser_truncation(series);
+    EXPECT_LT(20u, d);
+    EXPECT_GT(100u, d);
+
+    // stationary data need no truncation
+    std::vector<double> noise;
+    for (int i = 0; i < 200; ++i)
+        noise.push_back(std::sin(1.3 * i));
+    EXPECT_GT(20u, alps::thermalization_detector::mser_truncation(noise));
+
+    // too short to decide
+    EXPECT_EQ(3u, alps::thermalization_detector::mser_truncation(std::vector<double>(3, 1.)));
+}
+
+TEST(thermalization, detector) {
+    alps::thermalization_detector detector(20, 64, 5);
+    EXPECT_FALSE(detector.enabled());
+    EXPECT_TRUE(detector.thermalized());
+    EXPECT_THROW(alps::thermalization_detector(20, 63), std::invalid_argument);
+
+    alps::accumulators::accumulator_set measurements;
+    measurements << alps::accumulators::MeanAccumulator<double>("x");
+    detector.watch("x");
+    EXPECT_TRUE(detector.enabled());
+    EXPECT_FALSE(detector.thermalized());
+
+    int sweep = 0;
+    for (; sweep < 100000 && !detector.ready(); ++sweep) {
+        measurements["x"] << std::exp(-sweep / 100.) + 0.01 * std::sin(1.3 * sweep);
+        detector.observe(measurements);
+    }
+    EXPECT_EQ(std::size_t(sweep), detector.sweeps());
+    EXPECT_LT(100, sweep);
+    EXPECT_GT(10000, sweep);
+
+    detector.finish();
+    EXPECT_TRUE(detector.thermalized());
+    EXPECT_LT(100u, detector.detected_sweeps());
+    EXPECT_GE(std::size_t(sweep), detector.detected_sweeps());
+}
+
+TEST(thermalization, run) {
+    alps::parameters_type<my_sim_type>::type params;
+    params["COUNT"] = 20000;
+    my_sim_type::define_parameters(params);
+
+    my_sim_type my_sim(params);
+    my_sim.thermalization().watch("Energy").watch("Magnetization");
+    EXPECT_TRUE(my_sim.run(alps::simple_time_callback(60)));
+    ASSERT_TRUE(my_sim.thermalization().thermalized());
+
+    // the warm-up data are discarded
+    const std::size_t warmup = my_sim.thermalization().sweeps();
+    EXPECT_LT(std::size_t(my_sim_type::TAU), my_sim.thermalization().detected_sweeps());
+    EXPECT_GE(warmup, my_sim.thermalization().detected_sweeps());
+    EXPECT_EQ(my_sim.total_sweeps() - long(warmup), long(my_sim.collect_results()["Energy"].count()));
+
+    alps::results_type<my_sim_type>::type results = alps::collect_results(my_sim);
+    EXPECT_NEAR(1., results["Energy"].mean<double>(), 0.05);
+
+    // the warm-up length is kept in the checkpoint
+    alps::testing::unique_file ufile("thermalization.h5.", alps::testing::unique_file::REMOVE_NOW);
+    my_sim.save(ufile.name());
+    my_sim_type restored(params);
+    restored.load(ufile.name());
+    EXPECT_TRUE(restored.thermalization().thermalized());
+    EXPECT_EQ(warmup, restored.thermalization().sweeps());
+    EXPECT_EQ(my_sim.thermalization().detected_sweeps(), restored.thermalization().detected_sweeps());
+}
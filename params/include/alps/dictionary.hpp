@@ -14,6 +14,8 @@
 namespace alps {
     namespace params_ns {
 
+        template <typename T> class param_handle;
+
         /// Python-like dictionary
         class dictionary {
           public:
@@ -22,10 +24,24 @@ namespace alps {
           private:
             typedef std::map<std::string, value_type> map_type;
             map_type map_;
+            unsigned long generation_; ///< Incremented on any (potential) modification; used by handles
 
           public:
             typedef map_type::const_iterator const_iterator;
 
+            /// Constructs an empty dictionary
+            dictionary() : map_(), generation_(0) {}
+
+            /// Copy constructor
+            dictionary(const dictionary& rhs) : map_(rhs.map_), generation_(0) {}
+
+            /// Assignment (invalidates the handles bound to this dictionary)
+            dictionary& operator=(const dictionary& rhs) {
+                map_=rhs.map_;
+                ++generation_;
+                return *this;
+            }
+
             /// Const-iterator to the beginning of the contained map
             const_iterator begin() const { return map_.begin(); }
 
@@ -42,9 +58,12 @@ namespace alps {
             std::size_t size() const { return map_.size(); }
 
             /// Erase an element if it exists
-            void erase(const std::string& key) { map_.erase(key); }
+            void erase(const std::string& key) { map_.erase(key); ++generation_; }
 
             /// Access with intent to assign
+            /** Invalidates the handles bound to this dictionary.
+                @note Assigning through a reference kept across handle reads is not detected.
+            */
             value_type& operator[](const std::string& key);
 
             /// Read-only access
@@ -73,8 +92,20 @@ namespace alps {
                 return it!=map_.end() && (it->second).isType<T>();
             }
 
-            /// Swap the dictionaries
-            friend void swap(dictionary& d1, dictionary& d2) { using std::swap; swap(d1.map_, d2.map_); }
+            /// Typed handle to the value of a key (see `param_handle`)
+            template <typename T>
+            param_handle<T> handle(const std::string& key) const;
+
+            /// Counter that changes whenever the dictionary may have been modified
+            unsigned long generation() const { return generation_; }
+
+            /// Swap the dictionaries (invalidates the handles bound to either one)
+            friend void swap(dictionary& d1, dictionary& d2) {
+                using std::swap;
+                swap(d1.map_, d2.map_);
+                ++d1.generation_;
+                ++d2.generation_;
+            }
 
             /// Compare two dictionaries (true if all entries are of the same type and value)
             bool equals(const dictionary& rhs) const;
@@ -85,10 +116,16 @@ namespace alps {
             /// Load the dictionary from an archive
             void load(alps::hdf5::archive& ar);
 
+            /// Append the dictionary to a flat buffer
+            void pack(detail::packed_buffer& buf) const;
+
+            /// Restore the dictionary from a flat buffer
+            void unpack(detail::packed_buffer& buf);
+
             friend std::ostream& operator<<(std::ostream&, const dictionary&);
 
 #ifdef ALPS_HAVE_MPI
-            /// Broadcast the dictionary
+            /// Broadcast the dictionary (packed into a single message)
             void broadcast(const alps::mpi::communicator& comm, int root);
 #endif
         };
@@ -124,5 +161,6 @@ namespace alps {
     } // params_ns::
 } // alps::
 
+#include "./params/param_handle.hpp"
 
 #endif /* ALPS_PARAMS_DICTIONARY_HPP_e15039548f43464996cad06f9c8a3220 */
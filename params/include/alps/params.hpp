@@ -113,7 +113,12 @@ namespace alps {
             std::string help_header_;
 
             void read_ini_file_(const std::string& inifile);
+            void read_ini_string_(const std::string& content);
             void initialize_(int argc, const char* const* argv, const char* hdf5_path);
+#ifdef ALPS_HAVE_MPI
+            void initialize_(int argc, const char* const* argv, const char* hdf5_path,
+                             const alps::mpi::communicator& comm, int root);
+#endif
 
             template <typename T>
             bool assign_to_name_(const std::string& name, const std::string& strval);
@@ -124,6 +129,8 @@ namespace alps {
             template <typename T>
             bool define_(const std::string& name, const std::string& descr);
 
+            friend class params_sweep;
+
           public:
             /// Default ctor
             params() : dictionary(), raw_kv_content_(), td_map_(), err_status_(), origins_(), help_header_() {}
@@ -253,12 +260,19 @@ namespace alps {
             /// Loads parameter object form an archive
             void load(alps::hdf5::archive&);
 
+            /// Appends the parameter object to a flat buffer
+            void pack(detail::packed_buffer& buf) const;
+
+            /// Restores the parameter object from a flat buffer
+            void unpack(detail::packed_buffer& buf);
+
             /// Prints parameters to a stream in an unspecified format
             friend
             std::ostream& operator<<(std::ostream&, const params&);
 
 #ifdef ALPS_HAVE_MPI
             // FIXME: should it be virtual?
+            /// Broadcast the parameter object, packed into a single message
             void broadcast(const alps::mpi::communicator& comm, int root);
 
             /// Collective (broadcasting) constructor from command line and parameter files.
@@ -267,6 +281,12 @@ namespace alps {
                 file is an HDF5, in which case restores the object
                 from the HDF5 file, ignoring the command line.
 
+                Only the root process accesses the files; the command
+                line on other processes is ignored. If parsing fails on
+                root, the constructor throws on all processes: root
+                rethrows the original exception, other processes throw
+                `std::runtime_error` with the same message.
+
                 @param comm : Communicator to use for broadcast
                 @param root : Root process to broadcast from
                 @param hdf5_path : path to HDF5 dataset containing the
@@ -281,10 +301,7 @@ namespace alps {
                   origins_(),
                   help_header_()
 
-            {
-                initialize_(argc,argv,hdf5_path);
-                broadcast(comm, root);
-            }
+            { initialize_(argc, argv, hdf5_path, comm, root); }
 #endif
         };
 
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file content_hash.hpp Defines content hashing of parameter sets and lookup of result archives by hash. */
+
+#ifndef ALPS_PARAMS_CONTENT_HASH_HPP_0e4a7d2b9c1f4a5e8b3d6c0f2a1e7b9d
+#define ALPS_PARAMS_CONTENT_HASH_HPP_0e4a7d2b9c1f4a5e8b3d6c0f2a1e7b9d
+
+#include <alps/dictionary.hpp>
+
+#include <string>
+#include <vector>
+
+namespace alps {
+    namespace params_ns {
+
+        /// 128-bit hash of the values in a dictionary, as 32 hexadecimal digits
+        /**
+           The hash covers the name, the type and the value of every entry that
+           holds a value, in a canonical (platform- and order-independent)
+           encoding; the order in which the values were supplied or defined,
+           their descriptions and the origins of a `params` object do not enter.
+           Equal dictionaries have equal hashes. Values of different types
+           (e.g., `int` 1 and `double` 1.0) hash differently.
+
+           `params::save()` stores the hash in the `@content_hash` attribute.
+        */
+        std::string content_hash(const dictionary& dict);
+
+        /// Finds result archives containing a parameter set with the given content hash
+        /**
+           Reads the `@content_hash` attribute of `path` in every HDF5 file in
+           directory `dir` (not recursing into subdirectories). Files that are
+           not HDF5 archives, that cannot be opened, or that have no such
+           attribute are skipped.
+
+           @returns names of the matching files, prefixed by `dir`, sorted
+        */
+        std::vector<std::string> find_archives_by_hash(const std::string& dir, const std::string& hash,
+                                                       const std::string& path="/parameters");
+
+    } // params_ns::
+} // alps::
+
+#endif /* ALPS_PARAMS_CONTENT_HASH_HPP_0e4a7d2b9c1f4a5e8b3d6c0f2a1e7b9d */
@@ -56,6 +56,7 @@ namespace alps {
 
         namespace detail {
             template <typename> struct is_allowed;
+            class packed_buffer;
         }
         
         class dict_value {
@@ -130,6 +131,12 @@ namespace alps {
             /// Loads the value from an archive
             void load(alps::hdf5::archive& ar);
 
+            /// Appends the name and the value to a flat buffer
+            void pack(detail::packed_buffer& buf) const;
+
+            /// Restores the name and the value from a flat buffer
+            void unpack(detail::packed_buffer& buf);
+
             /// Const-access visitor to the bound value
             /** @param visitor functor should be callable as `R result=visitor(bound_value_const_ref)`
 
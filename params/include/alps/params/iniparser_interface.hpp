@@ -31,6 +31,9 @@ namespace alps {
                 /// Reads the INI file and parses it
                 iniparser(const std::string& inifile);
 
+                /// Parses the INI-formatted `content`; `name` identifies it in error messages
+                iniparser(const std::string& name, const std::string& content);
+
                 ~iniparser();
 
                 /// Returns a container (actually, vector of pairs) of keys and values
@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file packed_buffer.hpp
+
+    @brief Header for flat memory serialization of dictionaries and parameters
+
+    Packing a whole object into one byte buffer allows to broadcast it
+    with two collectives (size and payload) instead of one or more
+    collectives per stored string.
+
+    @note These are implementation details as of now
+*/
+
+#ifndef ALPS_PARAMS_PACKED_BUFFER_HPP_3f6c1d0e8a5b4c2f9e7d6a1b0c9f8e7d
+#define ALPS_PARAMS_PACKED_BUFFER_HPP_3f6c1d0e8a5b4c2f9e7d6a1b0c9f8e7d
+
+#include <alps/config.hpp>
+
+#include <alps/params/serialize_variant.hpp>
+#include <alps/params/dict_types.hpp>
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef ALPS_HAVE_MPI
+#include <alps/utilities/mpi.hpp>
+#endif
+
+namespace alps {
+    namespace params_ns {
+        namespace detail {
+
+            /// Growable byte buffer with sequential write and read access
+            /** Values are stored in their native representation, so the
+                buffer is only meaningful between processes of the same
+                architecture (as is the case for an MPI broadcast).
+            */
+            class packed_buffer {
+                std::vector<char> data_;
+                std::size_t pos_;
+
+                void read_(void* dest, std::size_t count) {
+                    if (count > data_.size()-pos_) throw std::runtime_error("packed_buffer: read past the end of the data");
+                    if (count) std::memcpy(dest, &data_[pos_], count);
+                    pos_ += count;
+                }
+
+                void write_(const void* src, std::size_t count) {
+                    const char* begin=static_cast<const char*>(src);
+                    data_.insert(data_.end(), begin, begin+count);
+                }
+
+                /// Vectors of arithmetic types are copied as one block
+                template <typename T>
+                struct is_block_copyable
+                    : boost::integral_constant<bool, boost::is_arithmetic<T>::value && !boost::is_same<T,bool>::value> {};
+
+                template <typename T>
+                void put_vector_(const std::vector<T>& val, boost::true_type) {
+                    put(val.size());
+                    if (!val.empty()) write_(&val[0], val.size()*sizeof(T));
+                }
+
+                template <typename T>
+                void put_vector_(const std::vector<T>& val, boost::false_type) {
+                    put(val.size());
+                    for (typename std::vector<T>::const_iterator it=val.begin(); it!=val.end(); ++it) {
+                        put(static_cast<const T&>(*it));
+                    }
+                }
+
+                template <typename T>
+                void get_vector_(std::vector<T>& val, boost::true_type) {
+                    std::size_t sz=0;
+                    get(sz);
+                    if (sz > (data_.size()-pos_)/sizeof(T)) throw std::runtime_error("packed_buffer: read past the end of the data");
+                    std::vector<T> newval(sz);
+                    if (sz) read_(&newval[0], sz*sizeof(T));
+                    val.swap(newval);
+                }
+
+                template <typename T>
+                void get_vector_(std::vector<T>& val, boost::false_type) {
+                    std::size_t sz=0;
+                    get(sz);
+                    std::vector<T> newval;
+                    newval.reserve(sz);
+                    for (std::size_t i=0; i<sz; ++i) {
+                        T elem;
+                        get(elem);
+                        newval.push_back(elem);
+                    }
+                    val.swap(newval);
+                }
+
+              public:
+                packed_buffer() : data_(), pos_(0) {}
+
+                /// Size of the packed data in bytes
+                std::size_t size() const { return data_.size(); }
+
+                /// Pointer to the packed data
+                char* data() { return data_.empty() ? 0 : &data_[0]; }
+
+                /// Discard the content and make room for `size` bytes to be filled in, e.g. by a broadcast
+                void resize(std::size_t size) { data_.assign(size, 0); pos_=0; }
+
+                /// True if all packed data has been read back
+                bool exhausted() const { return pos_==data_.size(); }
+
+                /// Append a value of an arithmetic type
+                template <typename T>
+                void put(const T& val) {
+                    BOOST_STATIC_ASSERT_MSG(boost::is_arithmetic<T>::value, "Only arithmetic types can be packed directly");
+                    write_(&val, sizeof(val));
+                }
+
+                void put(const std::string& val) {
+                    put(val.size());
+                    write_(val.data(), val.size());
+                }
+
+                template <typename T>
+                void put(const std::vector<T>& val) {
+                    put_vector_(val, is_block_copyable<T>());
+                }
+
+                template <typename K, typename V>
+                void put(const std::map<K,V>& val) {
+                    put(val.size());
+                    for (typename std::map<K,V>::const_iterator it=val.begin(); it!=val.end(); ++it) {
+                        put(it->first);
+                        put(it->second);
+                    }
+                }
+
+                /// Extract a value of an arithmetic type
+                template <typename T>
+                void get(T& val) {
+                    BOOST_STATIC_ASSERT_MSG(boost::is_arithmetic<T>::value, "Only arithmetic types can be unpacked directly");
+                    read_(&val, sizeof(val));
+                }
+
+                void get(std::string& val) {
+                    std::size_t sz=0;
+                    get(sz);
+                    if (sz > data_.size()-pos_) throw std::runtime_error("packed_buffer: read past the end of the data");
+                    val.assign(sz ? &data_[pos_] : "", sz);
+                    pos_ += sz;
+                }
+
+                template <typename T>
+                void get(std::vector<T>& val) {
+                    get_vector_(val, is_block_copyable<T>());
+                }
+
+                template <typename K, typename V>
+                void get(std::map<K,V>& val) {
+                    std::size_t sz=0;
+                    get(sz);
+                    std::map<K,V> newval;
+                    for (std::size_t i=0; i<sz; ++i) {
+                        K key;
+                        get(key);
+                        get(newval[key]);
+                    }
+                    val.swap(newval);
+                }
+            };
+
+            /// Consumer class to pack the bound value of a variant
+            struct pack_consumer {
+                packed_buffer& buf_;
+
+                explicit pack_consumer(packed_buffer& buf) : buf_(buf) {}
+
+                template <typename T>
+                void operator()(const T& val) { buf_.put(val); }
+
+                void operator()(const None&) {}
+            };
+
+            /// Producer class to unpack the bound value of a variant
+            struct unpack_producer {
+                packed_buffer& buf_;
+                int target_which;
+                int which_count;
+
+                unpack_producer(packed_buffer& buf, int which)
+                    : buf_(buf), target_which(which), which_count(0)
+                {}
+
+                template <typename T>
+                boost::optional<T> operator()(const T*)
+                {
+                    boost::optional<T> ret;
+                    if (target_which==which_count) {
+                        T val;
+                        buf_.get(val);
+                        ret=val;
+                    }
+                    ++which_count;
+                    return ret;
+                }
+
+                boost::optional<None> operator()(const None*)
+                {
+                    ++which_count;
+                    return boost::none;
+                }
+            };
+
+            typedef alps::detail::variant_serializer<dict_all_types,
+                                                     pack_consumer, unpack_producer> var_packer;
+
+            /// Append a variant (its type index followed by the bound value)
+            inline void pack(packed_buffer& buf, const var_packer::variant_type& var)
+            {
+                buf.put(var.which());
+                pack_consumer consumer(buf);
+                var_packer::consume(consumer, var);
+            }
+
+            /// Extract a variant packed by `pack()`
+            inline void unpack(packed_buffer& buf, var_packer::variant_type& var)
+            {
+                int which=-1;
+                buf.get(which);
+                unpack_producer producer(buf, which);
+                var=var_packer::produce(producer);
+                if (var.which()!=which) throw std::runtime_error("packed_buffer: invalid variant type index");
+            }
+
+#ifdef ALPS_HAVE_MPI
+            /// Broadcast the content of the buffer from `root`: the size first, then the payload
+            inline void broadcast(const alps::mpi::communicator& comm, packed_buffer& buf, int root)
+            {
+                using alps::mpi::broadcast;
+                std::size_t sz=buf.size();
+                broadcast(comm, sz, root);
+                if (comm.rank()!=root) buf.resize(sz);
+                if (sz) broadcast(comm, buf.data(), sz, root);
+            }
+#endif
+
+        } // detail::
+    } // params_ns::
+} // alps::
+
+#endif /* ALPS_PARAMS_PACKED_BUFFER_HPP_3f6c1d0e8a5b4c2f9e7d6a1b0c9f8e7d */
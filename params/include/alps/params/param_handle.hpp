@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file param_handle.hpp Defines typed cached handles to dictionary values. */
+
+#ifndef ALPS_PARAMS_PARAM_HANDLE_HPP_7b2e4c9a1d8f4e3a8c6b5d0e2f1a9c7b
+#define ALPS_PARAMS_PARAM_HANDLE_HPP_7b2e4c9a1d8f4e3a8c6b5d0e2f1a9c7b
+
+#include <string>
+
+#include "../dictionary.hpp"
+
+namespace alps {
+    namespace params_ns {
+
+        /// Typed handle to a dictionary value
+        /** The value is looked up and converted to `T` when the handle is
+            created, and cached. Reading the handle compares the generation
+            of the dictionary with the cached one, and re-reads the value only
+            if the dictionary has been modified (assigned, swapped, loaded,
+            broadcast, or accessed via non-const `operator[]`) since.
+
+            Usage:
+            @code
+            alps::params_ns::param_handle<double> beta=par.handle<double>("beta");
+            for (...) { energy += *beta * x; }
+            @endcode
+
+            @note The handle refers to the dictionary: it must not outlive it.
+            @note Re-reading throws the same exceptions as `dict_value::as<T>()`
+                  (or `exception::uninitialized_value` if the key was erased).
+        */
+        template <typename T>
+        class param_handle {
+            const dictionary* dict_;
+            std::string key_;
+            mutable T value_;
+            mutable unsigned long generation_; ///< Generation of the dictionary when `value_` was read
+
+            void refresh_() const {
+                value_=(*dict_)[key_].template as<T>();
+                generation_=dict_->generation();
+            }
+
+          public:
+            typedef T value_type;
+
+            /// Resolves the key in the dictionary; throws if it is missing or not convertible to `T`
+            param_handle(const dictionary& dict, const std::string& key)
+                : dict_(&dict), key_(key), value_(), generation_()
+            {
+                refresh_();
+            }
+
+            /// The key this handle refers to
+            const std::string& key() const { return key_; }
+
+            /// Current value
+            const T& get() const {
+                if (generation_!=dict_->generation()) refresh_();
+                return value_;
+            }
+
+            /// Current value
+            const T& operator*() const { return get(); }
+
+            /// Member access to the current value
+            const T* operator->() const { return &get(); }
+
+            /// Implicit conversion to the current value
+            operator const T&() const { return get(); }
+        };
+
+        template <typename T>
+        inline param_handle<T> dictionary::handle(const std::string& key) const {
+            return param_handle<T>(*this, key);
+        }
+
+    } // params_ns::
+} // alps::
+
+#endif /* ALPS_PARAMS_PARAM_HANDLE_HPP_7b2e4c9a1d8f4e3a8c6b5d0e2f1a9c7b */
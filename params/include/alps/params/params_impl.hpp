@@ -14,6 +14,7 @@
 #include <boost/optional.hpp>
 #include <locale> // FIXME: needed only for boolean conversions
 #include <boost/foreach.hpp> // FIXME: needed only for boolean conversions
+#include <algorithm>
 
 namespace alps {
     namespace params_ns {
@@ -31,6 +32,16 @@ namespace alps {
                     }
                     return result;
                 }
+
+                /// Parse a range of characters (without making a string of it)
+                static boost::optional<T> apply(const char* first, std::size_t count) {
+                    T conv_result;
+                    boost::optional<T> result;
+                    if (boost::conversion::try_lexical_convert(first, count, conv_result)) {
+                        result=conv_result;
+                    }
+                    return result;
+                }
             };
 
             template <>
@@ -38,6 +49,10 @@ namespace alps {
                 static boost::optional<std::string> apply(const std::string& in) {
                     return in;
                 }
+
+                static boost::optional<std::string> apply(const char* first, std::size_t count) {
+                    return std::string(first, count);
+                }
             };
 
             template <>
@@ -52,6 +67,10 @@ namespace alps {
                     if (in=="false" || in=="off" || in=="no" || in=="0") result=false;
                     return result;
                 }
+
+                static boost::optional<bool> apply(const char* first, std::size_t count) {
+                    return apply(std::string(first, count));
+                }
             };
 
             template <typename T>
@@ -60,19 +79,24 @@ namespace alps {
                     typedef std::vector<T> value_type;
                     typedef boost::optional<value_type> result_type;
                     typedef boost::optional<T> optional_el_type;
-                    typedef std::string::const_iterator sit_type;
-                    value_type result_vec;
                     result_type result;
-                    sit_type it1=in.begin();
-                    while (it1!=in.end()) {
-                        sit_type it2=find(it1, in.end(), ',');
-                        optional_el_type elem=parse_string<T>::apply(std::string(it1,it2));
+                    // Array values may have many thousands of elements:
+                    // elements are converted in place, and the vector is allocated once.
+                    const char* const begin=in.data();
+                    const char* const end=begin+in.size();
+                    value_type result_vec;
+                    result_vec.reserve(std::count(begin, end, ',')+1);
+                    const char* it1=begin;
+                    while (it1!=end) {
+                        const char* it2=std::find(it1, end, ',');
+                        optional_el_type elem=parse_string<T>::apply(it1, it2-it1);
                         if (!elem) return result;
                         result_vec.push_back(*elem);
-                        if (it2!=in.end()) ++it2;
+                        if (it2!=end) ++it2;
                         it1=it2;
                     }
-                    result=result_vec;
+                    result=value_type();
+                    result->swap(result_vec);
                     return result;
                 }
             };
@@ -158,6 +182,7 @@ namespace alps {
             swap(p1.td_map_, p2.td_map_);
             swap(p1.err_status_, p2.err_status_);
             swap(p1.origins_.data(), p2.origins_.data());
+            swap(p1.help_header_, p2.help_header_);
         }
 
         inline std::string origin_name(const params& p)
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file params_sweep.hpp Defines expansion of parameter sweeps into indexed parameter sets. */
+
+#ifndef ALPS_PARAMS_PARAMS_SWEEP_HPP_5c8e1f2a3b4d4e6f9a0b1c2d3e4f5a6b
+#define ALPS_PARAMS_PARAMS_SWEEP_HPP_5c8e1f2a3b4d4e6f9a0b1c2d3e4f5a6b
+
+#include <alps/params.hpp>
+
+#include <string>
+#include <vector>
+
+namespace alps {
+    namespace params_ns {
+
+        /// Indexed sequence of parameter sets described by sweep values in one parameter object
+        /**
+           A supplied (file or command line) value of the form
+
+           - `linspace(start, stop, count)` : `count` evenly spaced numbers, `stop` included;
+           - `range(start, stop, step)` : numbers from `start` up to, but not including, `stop`;
+             `step` may be omitted and defaults to 1;
+           - `list(a, b, ...)` : the explicit values `a`, `b`, ... (of any type)
+
+           makes the parameter "swept". Sweep points are combined either as the
+           cartesian product of all swept parameters (the first one in
+           alphabetical order varying slowest) or zipped (all swept parameters
+           must then have the same number of values).
+
+           Points are generated on request, so that a driver can hand out the
+           indices without materializing all parameter sets:
+           @code
+           alps::params p(argc, argv);          // e.g. "beta=linspace(1, 20, 64)" "L=list(8, 16, 32)"
+           alps::params_ns::params_sweep sweep(p);
+           for (std::size_t i=comm.rank(); i<sweep.size(); i+=comm.size()) {
+               alps::params pi=sweep[i];        // "beta" and "L" hold the values of the i-th point
+               pi.define<double>("beta", "Inverse temperature").define<int>("L", "System size");
+               ...
+           }
+           @endcode
+
+           @note The sweep must be created before the swept parameters are defined.
+        */
+        class params_sweep {
+          public:
+            /// How the values of different swept parameters are combined
+            enum mode_type {
+                CARTESIAN, ///< all combinations
+                ZIP        ///< n-th values of all swept parameters together
+            };
+
+          private:
+            /// Values of one swept parameter
+            struct axis_type {
+                enum kind_type { LINSPACE, RANGE, LIST };
+
+                std::string key;
+                kind_type kind;
+                double start, stop, step;
+                std::size_t count;
+                std::vector<std::string> items; ///< values of a `list()`
+
+                /// Returns the n-th value as the string to be parsed by `define()`
+                std::string value(std::size_t n) const;
+            };
+
+            params base_;
+            mode_type mode_;
+            std::vector<axis_type> axes_;
+            std::size_t size_;
+
+            std::size_t axis_index_(std::size_t n, std::size_t iaxis) const;
+
+          public:
+            /// Finds the swept parameters in `base`; throws `exception::value_mismatch` on malformed sweeps
+            explicit params_sweep(const params& base, mode_type mode=CARTESIAN);
+
+            /// Number of parameter sets (1 if nothing is swept)
+            std::size_t size() const { return size_; }
+
+            /// Names of the swept parameters, in alphabetical order
+            std::vector<std::string> keys() const;
+
+            /// Value (as supplied to `define()`) of swept parameter `key` at point `n`
+            std::string value(std::size_t n, const std::string& key) const;
+
+            /// Parameter set at point `n`: the base parameters with the swept values substituted
+            params operator[](std::size_t n) const;
+        };
+
+    } // params_ns::
+} // alps::
+
+#endif /* ALPS_PARAMS_PARAMS_SWEEP_HPP_5c8e1f2a3b4d4e6f9a0b1c2d3e4f5a6b */
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+#ifndef ALPS_PARAMS_THREAD_POOL_PARAMS_INCLUDED
+#define ALPS_PARAMS_THREAD_POOL_PARAMS_INCLUDED
+
+#include "alps/params.hpp"
+#include "alps/utilities/thread_pool.hpp"
+
+namespace alps {
+    namespace params_ns {
+        /// @brief Defines the parameters of the shared thread pool.
+        /// Defines `size_t num_threads` (0 means: from the environment, or all hardware threads).
+        inline params& define_thread_pool_parameters(params & parameters) {
+            return parameters
+                .define<std::size_t>("num_threads", 0, "number of threads per process (0: ALPS_NUM_THREADS or all cores)")
+                ;
+        }
+
+        /// @brief Sizes the default thread pool as requested by `num_threads`.
+        /// In MPI runs, consider `alps::threading::configure(comm, p["num_threads"])` instead.
+        inline void configure_thread_pool(const params & parameters) {
+            alps::threading::set_num_threads(parameters["num_threads"].as<std::size_t>());
+        }
+    } // end of namespace params_ns
+    using params_ns::define_thread_pool_parameters;
+    using params_ns::configure_thread_pool;
+} // end of namespace alps
+#endif
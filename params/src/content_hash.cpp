@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file content_hash.cpp
+    Contains implementation of content hashing of parameter sets */
+
+#include <alps/params/content_hash.hpp>
+#include <alps/hdf5/archive.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/cstdint.hpp>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace alps {
+    namespace params_ns {
+
+        namespace {
+            typedef boost::uint64_t uint64;
+            typedef std::vector<unsigned char> bytes_type;
+
+            inline uint64 rotl64(uint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+
+            inline uint64 fmix64(uint64 k)
+            {
+                k ^= k >> 33;
+                k *= 0xff51afd7ed558ccdULL;
+                k ^= k >> 33;
+                k *= 0xc4ceb9fe1a85ec53ULL;
+                k ^= k >> 33;
+                return k;
+            }
+
+            // Little-endian load of n<=8 bytes
+            inline uint64 load_le(const unsigned char* p, std::size_t n)
+            {
+                uint64 val=0;
+                for (std::size_t i=n; i>0; --i) val=(val<<8) | p[i-1];
+                return val;
+            }
+
+            // MurmurHash3_x64_128 by Austin Appleby (public domain), seed 0
+            void murmur3_128(const bytes_type& data, uint64& h1, uint64& h2)
+            {
+                const uint64 c1=0x87c37b91114253d5ULL;
+                const uint64 c2=0x4cf5ad432745937fULL;
+                const std::size_t len=data.size();
+                const unsigned char* p=data.empty() ? 0 : &data[0];
+                h1=h2=0;
+                std::size_t pos=0;
+                for (; pos+16<=len; pos+=16) {
+                    uint64 k1=load_le(p+pos, 8), k2=load_le(p+pos+8, 8);
+                    k1*=c1; k1=rotl64(k1,31); k1*=c2; h1^=k1;
+                    h1=rotl64(h1,27); h1+=h2; h1=h1*5+0x52dce729;
+                    k2*=c2; k2=rotl64(k2,33); k2*=c1; h2^=k2;
+                    h2=rotl64(h2,31); h2+=h1; h2=h2*5+0x38495ab5;
+                }
+                const std::size_t rem=len-pos;
+                if (rem>8) {
+                    uint64 k2=load_le(p+pos+8, rem-8);
+                    k2*=c2; k2=rotl64(k2,33); k2*=c1; h2^=k2;
+                }
+                if (rem>0) {
+                    uint64 k1=load_le(p+pos, std::min<std::size_t>(rem, 8));
+                    k1*=c1; k1=rotl64(k1,31); k1*=c2; h1^=k1;
+                }
+                h1^=len; h2^=len;
+                h1+=h2; h2+=h1;
+                h1=fmix64(h1); h2=fmix64(h2);
+                h1+=h2; h2+=h1;
+            }
+
+            /// Visitor to append the canonical encoding of a value: little-endian, 64-bit integers and doubles
+            class encoder : public boost::static_visitor<> {
+                bytes_type& out_;
+
+                void put_(uint64 val) const {
+                    for (int i=0; i<8; ++i) out_.push_back(static_cast<unsigned char>(val >> (8*i)));
+                }
+
+              public:
+                explicit encoder(bytes_type& out) : out_(out) {}
+
+                void operator()(const detail::None&) const {}
+                void operator()(bool val) const { out_.push_back(val ? 1 : 0); }
+                void operator()(int val) const { put_(static_cast<uint64>(static_cast<boost::int64_t>(val))); }
+                void operator()(long val) const { put_(static_cast<uint64>(static_cast<boost::int64_t>(val))); }
+                void operator()(unsigned int val) const { put_(val); }
+                void operator()(unsigned long val) const { put_(val); }
+                void operator()(float val) const { (*this)(static_cast<double>(val)); }
+
+                void operator()(double val) const {
+                    if (val==0) val=0.; // no negative zero
+                    uint64 bits;
+                    std::memcpy(&bits, &val, sizeof(bits));
+                    put_(bits);
+                }
+
+                void operator()(const std::string& val) const {
+                    put_(val.size());
+                    out_.insert(out_.end(), val.begin(), val.end());
+                }
+
+                template <typename T>
+                void operator()(const std::vector<T>& val) const {
+                    put_(val.size());
+                    for (typename std::vector<T>::const_iterator it=val.begin(); it!=val.end(); ++it) {
+                        (*this)(static_cast<T>(*it));
+                    }
+                }
+            };
+
+            /// Visitor returning the name of the bound type
+            struct type_name : public boost::static_visitor<std::string> {
+                template <typename T>
+                std::string operator()(const T&) const { return detail::type_info<T>::pretty_name(); }
+            };
+
+            // Closes the directory stream on scope exit
+            struct dir_closer {
+                DIR* dirp;
+                explicit dir_closer(DIR* d) : dirp(d) {}
+                ~dir_closer() { closedir(dirp); }
+            };
+
+            // Checks the HDF5 signature without involving the HDF5 library
+            bool is_hdf5_file(const std::string& fname)
+            {
+                static const char hdf5_signature[]={char(137),72,68,70,13,10,26,10};
+                std::ifstream f(fname.c_str(), std::ios::binary);
+                char firstbytes[sizeof(hdf5_signature)];
+                f.read(firstbytes, sizeof(firstbytes));
+                return f.good() && std::memcmp(hdf5_signature, firstbytes, sizeof(firstbytes))==0;
+            }
+        }
+
+        std::string content_hash(const dictionary& dict)
+        {
+            bytes_type bytes;
+            const encoder encode(bytes);
+            // dictionary is ordered by key, so the encoding does not depend on the order of insertion
+            for (dictionary::const_iterator it=dict.begin(); it!=dict.end(); ++it) {
+                if (it->second.empty()) continue;
+                encode(it->first);
+                encode(apply_visitor(type_name(), it));
+                apply_visitor(encode, it);
+            }
+
+            uint64 h[2];
+            murmur3_128(bytes, h[0], h[1]);
+            static const char digits[]="0123456789abcdef";
+            std::string result;
+            result.reserve(32);
+            for (int i=0; i<16; ++i) {
+                const unsigned int byte=static_cast<unsigned int>(h[i/8] >> (8*(i%8))) & 0xff;
+                result+=digits[byte >> 4];
+                result+=digits[byte & 0xf];
+            }
+            return result;
+        }
+
+        std::vector<std::string> find_archives_by_hash(const std::string& dir, const std::string& hash,
+                                                       const std::string& path)
+        {
+            DIR* dirp=opendir(dir.c_str());
+            if (!dirp) throw std::runtime_error("find_archives_by_hash(): cannot open directory '"+dir+"'");
+            dir_closer closer(dirp);
+
+            std::vector<std::string> result;
+            const std::string attr=path+"@content_hash";
+            while (const dirent* entry=readdir(dirp)) {
+                const std::string fname=dir+"/"+entry->d_name;
+                struct stat st;
+                if (stat(fname.c_str(), &st)!=0 || !S_ISREG(st.st_mode) || !is_hdf5_file(fname)) continue;
+                try {
+                    alps::hdf5::archive ar(fname, "r");
+                    if (!ar.is_attribute(attr)) continue;
+                    std::string stored;
+                    ar[attr] >> stored;
+                    if (stored==hash) result.push_back(fname);
+                } catch (const alps::hdf5::archive_error&) {
+                    // not a readable archive: skip
+                }
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+    } // params_ns::
+} // alps::
@@ -9,6 +9,7 @@
 
 #include <alps/params/dict_value.hpp>
 #include <alps/params/hdf5_variant.hpp>
+#include <alps/params/packed_buffer.hpp>
 
 #ifdef ALPS_HAVE_MPI
 #include <alps/params/mpi_variant.hpp>
@@ -185,6 +186,18 @@ namespace alps {
             return s;
         }
 
+        void dict_value::pack(detail::packed_buffer& buf) const
+        {
+            buf.put(name_);
+            detail::pack(buf, val_);
+        }
+
+        void dict_value::unpack(detail::packed_buffer& buf)
+        {
+            buf.get(name_);
+            detail::unpack(buf, val_);
+        }
+
 #ifdef ALPS_HAVE_MPI
         void dict_value::broadcast(const alps::mpi::communicator& comm, int root)
         {
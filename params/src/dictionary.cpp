@@ -9,11 +9,9 @@
 
 #include <alps/dictionary.hpp>
 
-#include <alps/hdf5/map.hpp>
+#include <alps/params/packed_buffer.hpp>
 
-#ifdef ALPS_HAVE_MPI
-#include <alps/utilities/mpi_map.hpp>
-#endif
+#include <alps/hdf5/map.hpp>
 
 namespace alps {
     namespace params_ns {
@@ -29,6 +27,7 @@ namespace alps {
         
         /// Access with intent to assign
         dictionary::value_type& dictionary::operator[](const std::string& key) {
+            ++generation_;
             map_type::iterator it=map_.lower_bound(key);
             if (it==map_.end() ||
                 map_.key_comp()(key, it->first)) {
@@ -79,6 +78,7 @@ namespace alps {
             
             using std::swap;
             swap(map_,new_map);
+            ++generation_;
         }
 
         std::ostream& operator<<(std::ostream& s, const dictionary& d)
@@ -89,11 +89,37 @@ namespace alps {
             return s;
         }
 
+        void dictionary::pack(detail::packed_buffer& buf) const
+        {
+            buf.put(map_.size());
+            for (map_type::const_iterator it=map_.begin(); it!=map_.end(); ++it) {
+                buf.put(it->first);
+                it->second.pack(buf);
+            }
+        }
+
+        void dictionary::unpack(detail::packed_buffer& buf)
+        {
+            std::size_t sz=0;
+            buf.get(sz);
+            map_type new_map;
+            for (std::size_t i=0; i<sz; ++i) {
+                std::string key;
+                buf.get(key);
+                new_map[key].unpack(buf);
+            }
+            using std::swap;
+            swap(map_,new_map);
+            ++generation_;
+        }
+
 #ifdef ALPS_HAVE_MPI
-        // Defined here to avoid including <mpi_map.hpp> inside user header
-        void dictionary::broadcast(const alps::mpi::communicator& comm, int root) { 
-            using alps::mpi::broadcast;
-            broadcast(comm, map_, root);
+        // Defined here to avoid including <packed_buffer.hpp> inside user header
+        void dictionary::broadcast(const alps::mpi::communicator& comm, int root) {
+            detail::packed_buffer buf;
+            if (comm.rank()==root) pack(buf);
+            detail::broadcast(comm, buf, root);
+            if (comm.rank()!=root) unpack(buf);
         }
 #endif
 
@@ -37,6 +37,12 @@ namespace alps {
                     if (!inidict_) throw std::runtime_error("Cannot read INI file " + inifile);
                 }
 
+                ini_dict_impl(const std::string& name, const std::string& content)
+                    : inidict_(iniparser_load_string(content.c_str(), name.c_str()))
+                {
+                    if (!inidict_) throw std::runtime_error("Cannot parse INI content of " + name);
+                }
+
                 ~ini_dict_impl() {
                     if (inidict_) iniparser_freedict(inidict_);
                 }
@@ -67,6 +73,9 @@ namespace alps {
             iniparser::iniparser(const std::string& inifile) : ini_dict_ptr_(new ini_dict_impl(inifile))
             {  }
 
+            iniparser::iniparser(const std::string& name, const std::string& content) : ini_dict_ptr_(new ini_dict_impl(name, content))
+            {  }
+
             iniparser::~iniparser()
             {  }
 
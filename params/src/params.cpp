@@ -8,29 +8,26 @@
     Contains implementation of alps::params */
 
 #include <alps/params/iniparser_interface.hpp>
+#include <alps/params/packed_buffer.hpp>
+#include <alps/params/content_hash.hpp>
 #include <alps/params.hpp>
 #include <algorithm>
 #include <sstream>
 #include <iomanip> // for help pretty-printing
 #include <iterator> // for ostream_iterator
 #include <cstring> // for memcmp()
+#include <exception> // for exception_ptr
 #include <boost/optional.hpp>
 
 #include <alps/testing/fp_compare.hpp>
 
-#include <alps/testing/unique_file.hpp> // FIXME!!! Temporary!
-#include <fstream> // FIXME!!! Temporary!
+#include <fstream>
 
 #include <alps/hdf5/map.hpp>
 #include <alps/hdf5/vector.hpp>
 
 #include <boost/foreach.hpp>
 
-#ifdef ALPS_HAVE_MPI
-#include <alps/utilities/mpi_map.hpp>
-#include <alps/utilities/mpi_vector.hpp>
-#endif
-
 
 namespace alps {
     namespace params_ns {
@@ -228,28 +225,34 @@ namespace alps {
                     cmd_options << arg.substr(key_begin) << "\n";
                 }
             }
-            // FIXME!!!
-            // This is very inefficient and is done only for testing.
-            alps::testing::unique_file tmpfile(origins_.data()[origins_type::ARGV0]+".param.ini", alps::testing::unique_file::REMOVE_AFTER);
-            std::ofstream tmpstream(tmpfile.name().c_str());
-            tmpstream << cmd_options.rdbuf();
-            tmpstream.close();
-            read_ini_file_(tmpfile.name());
-            origins_.data().pop_back(); // remove the "invisible" ini file
+            read_ini_string_(cmd_options.str());
         }
-        
+
+        namespace {
+            // Helper function to merge the parsed key-value pairs into the map of raw values
+            void merge_kv(std::map<std::string,std::string>& kv_map, const detail::iniparser& parser)
+            {
+                BOOST_FOREACH(const detail::iniparser::kv_pair& kv, parser()) {
+                    // FIXME!!! Check for duplicates and optionally warn!
+                    std::string key=kv.first;
+                    if (!key.empty() && key[0]=='.') key.erase(0,1);
+                    kv_map[key]=kv.second;
+                }
+            }
+        }
+
         void params::read_ini_file_(const std::string& inifile)
         {
-            detail::iniparser parser(inifile);
-            BOOST_FOREACH(const detail::iniparser::kv_pair& kv, parser()) {
-                // FIXME!!! Check for duplicates and optionally warn!
-                std::string key=kv.first;
-                if (!key.empty() && key[0]=='.') key.erase(0,1);
-                raw_kv_content_[key]=kv.second;
-            }
+            merge_kv(raw_kv_content_, detail::iniparser(inifile));
             origins_.data().push_back(inifile);
         }
 
+        void params::read_ini_string_(const std::string& content)
+        {
+            // the command line is not an ini file, so it is not recorded in origins
+            merge_kv(raw_kv_content_, detail::iniparser("command line", content));
+        }
+
         const std::string params::get_descr(const std::string& name) const
         {
             td_map_type::const_iterator it=td_map_.find(name);
@@ -287,6 +290,7 @@ namespace alps {
             ar[context+"@status"] << err_status_;
             ar[context+"@origins"]  << origins_.data();
             ar[context+"@help_header"]  << help_header_;
+            ar[context+"@content_hash"]  << content_hash(*this);
             
             std::vector<std::string> keys=ar.list_children(context);
             BOOST_FOREACH(const std::string& key, keys) {
@@ -358,6 +362,46 @@ namespace alps {
             swap(*this, newpar);
         }
 
+        void params::pack(detail::packed_buffer& buf) const
+        {
+            dictionary::pack(buf);
+            buf.put(raw_kv_content_);
+            buf.put(td_map_.size());
+            BOOST_FOREACH(const td_map_type::value_type& tdp, td_map_) {
+                buf.put(tdp.first);
+                buf.put(tdp.second.typestr());
+                buf.put(tdp.second.descr());
+                buf.put(tdp.second.defnumber());
+            }
+            buf.put(err_status_);
+            buf.put(origins_.data());
+            buf.put(help_header_);
+        }
+
+        void params::unpack(detail::packed_buffer& buf)
+        {
+            params newpar;
+            newpar.dictionary::unpack(buf);
+            buf.get(newpar.raw_kv_content_);
+            std::size_t td_size=0;
+            buf.get(td_size);
+            for (std::size_t i=0; i<td_size; ++i) {
+                std::string key;
+                buf.get(key);
+                detail::td_type& td=newpar.td_map_[key];
+                buf.get(td.typestr());
+                buf.get(td.descr());
+                buf.get(td.defnumber());
+            }
+            buf.get(newpar.err_status_);
+            buf.get(newpar.origins_.data());
+            newpar.origins_.check();
+            buf.get(newpar.help_header_);
+
+            using std::swap;
+            swap(*this, newpar);
+        }
+
         namespace {
             // Printing of a vector
             // FIXME!!! Consolidate with other definitions and move to alps::utilities
@@ -409,13 +453,39 @@ namespace alps {
 
 #ifdef ALPS_HAVE_MPI
         void params::broadcast(const alps::mpi::communicator& comm, int rank) {
-            this->dictionary::broadcast(comm, rank);
-            using alps::mpi::broadcast;
-            broadcast(comm, raw_kv_content_, rank);
-            broadcast(comm, td_map_, rank);
-            broadcast(comm, err_status_, rank);
-            broadcast(comm, origins_.data(), rank);
-            origins_.check();
+            detail::packed_buffer buf;
+            if (comm.rank()==rank) pack(buf);
+            detail::broadcast(comm, buf, rank);
+            if (comm.rank()!=rank) unpack(buf);
+        }
+
+        void params::initialize_(int argc, const char* const* argv, const char* hdf5_path,
+                                 const alps::mpi::communicator& comm, int root)
+        {
+            // The error message (empty on success) goes in the same message as the parsed object,
+            // so that all processes either succeed or fail together.
+            detail::packed_buffer buf;
+            std::exception_ptr root_error;
+            if (comm.rank()==root) {
+                std::string errmsg;
+                try {
+                    initialize_(argc, argv, hdf5_path);
+                } catch (const std::exception& exc) {
+                    root_error=std::current_exception();
+                    errmsg=exc.what();
+                    if (errmsg.empty()) errmsg="unknown error";
+                }
+                buf.put(errmsg);
+                if (!root_error) pack(buf);
+            }
+            detail::broadcast(comm, buf, root);
+            if (root_error) std::rethrow_exception(root_error);
+            if (comm.rank()!=root) {
+                std::string errmsg;
+                buf.get(errmsg);
+                if (!errmsg.empty()) throw std::runtime_error("Parsing of parameters failed on the root process: "+errmsg);
+                unpack(buf);
+            }
         }
 #endif
     } // ::params_ns
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file params_sweep.cpp
+    Contains implementation of alps::params_ns::params_sweep */
+
+#include <alps/params/params_sweep.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/foreach.hpp>
+
+namespace alps {
+    namespace params_ns {
+
+        namespace {
+            std::string trim(const std::string& str)
+            {
+                static const char blanks[]=" \t";
+                const std::string::size_type first=str.find_first_not_of(blanks);
+                if (first==std::string::npos) return std::string();
+                const std::string::size_type last=str.find_last_not_of(blanks);
+                return str.substr(first, last-first+1);
+            }
+
+            // Splits a comma-separated argument list, trimming the elements
+            std::vector<std::string> split_args(const std::string& args)
+            {
+                std::vector<std::string> result;
+                std::string::size_type begin=0;
+                while (true) {
+                    const std::string::size_type end=args.find(',', begin);
+                    result.push_back(trim(args.substr(begin, end==std::string::npos ? std::string::npos : end-begin)));
+                    if (end==std::string::npos) break;
+                    begin=end+1;
+                }
+                return result;
+            }
+
+            double parse_number(const std::string& key, const std::string& str)
+            {
+                const char* begin=str.c_str();
+                char* end=0;
+                const double result=std::strtod(begin, &end);
+                if (str.empty() || *end!='\0' || !(std::fabs(result)<=std::numeric_limits<double>::max()))
+                    throw exception::value_mismatch(key, "Invalid number '"+str+"' in parameter sweep");
+                return result;
+            }
+
+            // Converts a (non-negative, integral) number of points, checking for overflow
+            std::size_t to_count(const std::string& key, double count)
+            {
+                if (!(count < std::ldexp(1., std::numeric_limits<std::size_t>::digits)))
+                    throw exception::value_mismatch(key, "Too many points in parameter sweep");
+                return static_cast<std::size_t>(count);
+            }
+
+            // Shortest representation that reads back as the same double
+            std::string format_number(double val)
+            {
+                char buf[32];
+                for (int prec=15; prec<=17; ++prec) {
+                    std::snprintf(buf, sizeof(buf), "%.*g", prec, val);
+                    if (std::strtod(buf, 0)==val) break;
+                }
+                return buf;
+            }
+        }
+
+        std::string params_sweep::axis_type::value(std::size_t n) const
+        {
+            if (kind==LIST) return items[n];
+            // the end point of linspace() is exact
+            if (kind==LINSPACE && count>1 && n==count-1) return format_number(stop);
+            return format_number(start+step*n);
+        }
+
+        params_sweep::params_sweep(const params& base, mode_type mode)
+            : base_(base), mode_(mode), axes_(), size_(1)
+        {
+            BOOST_FOREACH(const params::strmap::value_type& kv, base_.raw_kv_content_) {
+                const std::string val=trim(kv.second);
+                const std::string::size_type open=val.find('(');
+                if (open==std::string::npos || val[val.size()-1]!=')') continue;
+
+                axis_type axis;
+                axis.key=kv.first;
+                const std::string func=trim(val.substr(0, open));
+                const std::vector<std::string> args=split_args(val.substr(open+1, val.size()-open-2));
+                if (func=="list") {
+                    axis.kind=axis_type::LIST;
+                    axis.start=axis.stop=axis.step=0;
+                    axis.items=args;
+                    axis.count=args.size();
+                    BOOST_FOREACH(const std::string& item, args) {
+                        if (item.empty()) throw exception::value_mismatch(axis.key, "Empty value in parameter sweep list");
+                    }
+                } else if (func=="linspace") {
+                    if (args.size()!=3) throw exception::value_mismatch(axis.key, "linspace() requires 3 arguments: start, stop, count");
+                    axis.kind=axis_type::LINSPACE;
+                    axis.start=parse_number(axis.key, args[0]);
+                    axis.stop=parse_number(axis.key, args[1]);
+                    const double count=parse_number(axis.key, args[2]);
+                    if (count<1 || count!=std::floor(count))
+                        throw exception::value_mismatch(axis.key, "linspace() count must be a positive integer");
+                    axis.count=to_count(axis.key, count);
+                    axis.step=(axis.count>1) ? (axis.stop-axis.start)/(axis.count-1) : 0.;
+                } else if (func=="range") {
+                    if (args.size()!=2 && args.size()!=3) throw exception::value_mismatch(axis.key, "range() requires 2 or 3 arguments: start, stop[, step]");
+                    axis.kind=axis_type::RANGE;
+                    axis.start=parse_number(axis.key, args[0]);
+                    axis.stop=parse_number(axis.key, args[1]);
+                    axis.step=(args.size()==3) ? parse_number(axis.key, args[2]) : 1.;
+                    if (axis.step==0) throw exception::value_mismatch(axis.key, "range() step must not be zero");
+                    const double count=std::ceil((axis.stop-axis.start)/axis.step);
+                    if (count<1) throw exception::value_mismatch(axis.key, "range() is empty");
+                    axis.count=to_count(axis.key, count);
+                } else {
+                    continue; // not a sweep: an ordinary value with parentheses
+                }
+                if (base_.td_map_.count(axis.key))
+                    throw std::logic_error("params_sweep: parameter '"+axis.key+"' is already defined; "
+                                           "the sweep must be created before the definitions");
+                axes_.push_back(axis);
+            }
+
+            BOOST_FOREACH(const axis_type& axis, axes_) {
+                if (mode_==ZIP) {
+                    if (axis.count!=axes_.front().count)
+                        throw exception::value_mismatch(axis.key, "Zipped parameter sweeps must have the same number of values");
+                    size_=axis.count;
+                } else {
+                    if (axis.count > std::numeric_limits<std::size_t>::max()/size_)
+                        throw std::overflow_error("params_sweep: too many points in the cartesian product");
+                    size_*=axis.count;
+                }
+            }
+        }
+
+        std::size_t params_sweep::axis_index_(std::size_t n, std::size_t iaxis) const
+        {
+            if (mode_==ZIP) return n;
+            // the last axis varies fastest
+            for (std::size_t i=axes_.size()-1; i>iaxis; --i) n/=axes_[i].count;
+            return n % axes_[iaxis].count;
+        }
+
+        std::vector<std::string> params_sweep::keys() const
+        {
+            std::vector<std::string> result;
+            BOOST_FOREACH(const axis_type& axis, axes_) {
+                result.push_back(axis.key);
+            }
+            return result;
+        }
+
+        std::string params_sweep::value(std::size_t n, const std::string& key) const
+        {
+            if (n>=size_) throw std::out_of_range("params_sweep: point index out of range");
+            for (std::size_t i=0; i<axes_.size(); ++i) {
+                if (axes_[i].key==key) return axes_[i].value(axis_index_(n, i));
+            }
+            throw exception::uninitialized_value(key, "Parameter is not swept");
+        }
+
+        params params_sweep::operator[](std::size_t n) const
+        {
+            if (n>=size_) throw std::out_of_range("params_sweep: point index out of range");
+            params point(base_);
+            for (std::size_t i=0; i<axes_.size(); ++i) {
+                point.raw_kv_content_[axes_[i].key]=axes_[i].value(axis_index_(n, i));
+            }
+            return point;
+        }
+
+    } // params_ns::
+} // alps::
@@ -11,6 +11,7 @@
 
 #include "./params_test_support.hpp"
 #include <alps/utilities/gtest_par_xml_output.hpp>
+#include <sstream>
 
 using alps::params;
 
@@ -84,6 +85,68 @@ TEST_F(ParamsTest, bcastCtor) {
     EXPECT_EQ("abc", p["my_string"].as<std::string>()) << "Observed on rank " << comm_.rank();
 }
 
+TEST_F(ParamsTest, bcastCtorRootOnlyFiles) {
+    std::string ini_name;
+    if (is_master_) {
+        ini_maker ini("params_bcast_mpi.ini.");
+        ini.add(test_data::inifile_content);
+        ini_name=ini.name();
+        // the file exists while the collective ctor runs on root only
+        arg_holder args;
+        args.add(ini_name);
+        params p(args.argc(), args.argv(), comm_, root_);
+        EXPECT_EQ(ini_name, p.get_ini_name(0));
+        EXPECT_EQ(1234, p.define<int>("my_int", "Integer")["my_int"].as<int>());
+    } else {
+        // other ranks pass a file that does not exist: it must not be opened
+        arg_holder args;
+        args.add("/nonexistent/directory/params_bcast_mpi.ini");
+        params p(args.argc(), args.argv(), comm_, root_);
+        EXPECT_EQ(1, p.get_ini_name_count()) << "Observed on rank " << comm_.rank();
+        EXPECT_EQ(1234, p.define<int>("my_int", "Integer")["my_int"].as<int>()) << "Observed on rank " << comm_.rank();
+    }
+}
+
+TEST_F(ParamsTest, bcastCtorError) {
+    arg_holder args;
+    args.add("/nonexistent/directory/params_bcast_mpi.ini");
+    if (is_master_) {
+        EXPECT_ANY_THROW(params(args.argc(), args.argv(), comm_, root_));
+    } else {
+        EXPECT_THROW(params(args.argc(), args.argv(), comm_, root_), std::runtime_error) << "Observed on rank " << comm_.rank();
+    }
+    // the communicator is still usable
+    int value=comm_.rank()==root_ ? 42 : 0;
+    alps::mpi::broadcast(comm_, value, root_);
+    EXPECT_EQ(42, value) << "Observed on rank " << comm_.rank();
+}
+
+TEST_F(ParamsTest, bcastDefinitions) {
+    arg_holder args;
+    args.add("my_int=1").add("--my_flag");
+    params p_on_root(args.argc(), args.argv());
+    p_on_root.description("Broadcast test")
+        .define<int>("my_int", "Integer")
+        .define< std::vector<double> >("my_vec", std::vector<double>(3, 0.25), "Vector")
+        .define("my_flag", "Flag")
+        .define<std::string>("my_missing", "Missing string");
+
+    params p;
+    if (is_master_) p=p_on_root;
+    broadcast(comm_, p, root_);
+
+    EXPECT_TRUE(p==p_on_root) << "Observed on rank " << comm_.rank();
+    EXPECT_TRUE(p.has_missing()) << "Observed on rank " << comm_.rank();
+    EXPECT_TRUE(p.defaulted("my_vec")) << "Observed on rank " << comm_.rank();
+    EXPECT_EQ(std::vector<double>(3, 0.25), p["my_vec"].as< std::vector<double> >()) << "Observed on rank " << comm_.rank();
+    EXPECT_TRUE(p["my_flag"].as<bool>()) << "Observed on rank " << comm_.rank();
+    EXPECT_EQ("Vector", p.get_descr("my_vec")) << "Observed on rank " << comm_.rank();
+    std::ostringstream help_on_root, help;
+    p_on_root.print_help(help_on_root);
+    p.print_help(help);
+    EXPECT_EQ(help_on_root.str(), help.str()) << "Observed on rank " << comm_.rank();
+}
+
 
 int main(int argc, char** argv)
 {
@@ -193,3 +193,20 @@ TEST_F(ParamsTestCmdline, doubleDash) {
     EXPECT_TRUE(!!p[ini1_as_key]) << "--file1... should be taken as option " << ini1_as_key;
     EXPECT_FALSE(!!p[ini2_as_key]) << "--file2... should be taken as file " << ini2_as_key;
 }
+
+TEST_F(ParamsTestCmdline, noFilesWritten) {
+    // options are parsed in memory: nothing is created next to the program, even if the directory does not exist
+    arg_holder args("/nonexistent/directory/program_name");
+    args.add("--one=1").add("--flag");
+
+    params p(args.argc(), args.argv());
+
+    ASSERT_TRUE(p
+                .define<int>("one", 0, "Option 1")
+                .define<bool>("flag", false, "Flag option")
+                .ok());
+
+    EXPECT_EQ(1, p["one"]);
+    EXPECT_TRUE(p["flag"].as<bool>());
+    EXPECT_EQ(0, p.get_ini_name_count());
+}
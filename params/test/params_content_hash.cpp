@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file params_content_hash.cpp
+
+    @brief Tests content hashing of parameters and lookup of archives by hash
+*/
+
+#include "./params_test_support.hpp"
+
+#include <alps/params/content_hash.hpp>
+#include <alps/testing/unique_file.hpp>
+
+#include <algorithm>
+
+using alps::params;
+using alps::params_ns::content_hash;
+using alps::params_ns::find_archives_by_hash;
+
+class ParamsHashTest : public ::testing::Test {
+  public:
+    params par_;
+
+    ParamsHashTest() {
+        arg_holder args("/some/dir/program_name");
+        args.add("beta=2.5").add("L=16").add("model=ising").add("unused=1");
+        params p(args.argc(), args.argv());
+        p
+            .define<double>("beta", "Inverse temperature")
+            .define<int>("L", "System size")
+            .define<std::string>("model", "Model name")
+            .define< std::vector<double> >("h", std::vector<double>(2, -0.0), "Fields");
+        EXPECT_TRUE(p.ok());
+        swap(par_, p);
+    }
+};
+
+TEST_F(ParamsHashTest, orderAndOriginIndependent) {
+    const std::string hash=content_hash(par_);
+    EXPECT_EQ(32u, hash.size());
+    EXPECT_EQ(std::string::npos, hash.find_first_not_of("0123456789abcdef"));
+
+    // different program, argument order, definition order, descriptions; no unused argument
+    arg_holder args("other_program");
+    args.add("model=ising").add("L=16").add("beta=2.5");
+    params p(args.argc(), args.argv());
+    p
+        .define< std::vector<double> >("h", std::vector<double>(2, 0.0), "")
+        .define<std::string>("model", "")
+        .define<int>("L", "")
+        .define<double>("beta", "");
+    EXPECT_EQ(hash, content_hash(p));
+}
+
+TEST_F(ParamsHashTest, valuesAndTypes) {
+    const std::string hash=content_hash(par_);
+    params p=par_;
+    p["beta"]=2.75;
+    EXPECT_NE(hash, content_hash(p));
+    p["beta"]=2.5;
+    EXPECT_EQ(hash, content_hash(p));
+    p["L"]=16.;
+    EXPECT_NE(hash, content_hash(p));
+    p["L"]=16;
+    p["extra"]=false;
+    EXPECT_NE(hash, content_hash(p));
+    EXPECT_NE(content_hash(params()), hash);
+}
+
+TEST_F(ParamsHashTest, findArchives) {
+    alps::testing::unique_file match("params_content_hash.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::testing::unique_file other("params_content_hash.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    {
+        alps::hdf5::archive ar(match.name(), "w");
+        ar["/parameters"] << par_;
+    }
+    {
+        params p=par_;
+        p["beta"]=3.;
+        alps::hdf5::archive ar(other.name(), "w");
+        ar["/parameters"] << p;
+    }
+    const std::string hash=content_hash(par_);
+    {
+        // the hash survives a save/load round trip
+        params p;
+        alps::hdf5::archive ar(match.name(), "r");
+        ar["/parameters"] >> p;
+        EXPECT_EQ(hash, content_hash(p));
+    }
+
+    std::vector<std::string> found=find_archives_by_hash(".", hash);
+    EXPECT_EQ(1, std::count(found.begin(), found.end(), "./"+match.name()));
+    EXPECT_EQ(0, std::count(found.begin(), found.end(), "./"+other.name()));
+    EXPECT_TRUE(find_archives_by_hash(".", hash, "/nonexistent").empty());
+    EXPECT_THROW(find_archives_by_hash("/nonexistent/directory", hash), std::runtime_error);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file params_handle.cpp
+
+    @brief Tests typed cached handles to parameters
+*/
+
+#include "./params_test_support.hpp"
+
+#include <alps/testing/unique_file.hpp>
+
+using alps::params_ns::param_handle;
+namespace de=alps::params_ns::exception;
+
+class ParamsHandleTest : public ::testing::Test {
+  public:
+    arg_holder args;
+    alps::params par;
+
+    ParamsHandleTest() {
+        args.add("beta=2.5").add("L=16").add("name=ising");
+        alps::params p(args.argc(), args.argv());
+        p
+            .define<double>("beta", "Inverse temperature")
+            .define<int>("L", "System size")
+            .define<std::string>("name", "Model name");
+        EXPECT_TRUE(p.ok()) << "parameter initialization";
+        swap(par, p);
+    }
+};
+
+TEST_F(ParamsHandleTest, readAndConvert) {
+    param_handle<double> beta=par.handle<double>("beta");
+    param_handle<double> size=par.handle<double>("L");
+    param_handle<std::string> name=par.handle<std::string>("name");
+    EXPECT_EQ("beta", beta.key());
+    EXPECT_EQ(2.5, *beta);
+    EXPECT_EQ(16., size.get());
+    EXPECT_EQ(5u, name->size());
+    const double& beta_ref=beta;
+    EXPECT_EQ(2.5, beta_ref);
+}
+
+TEST_F(ParamsHandleTest, resolveErrors) {
+    EXPECT_THROW(par.handle<double>("nonexistent"), de::uninitialized_value);
+    EXPECT_THROW(par.handle<int>("beta"), de::type_mismatch);
+}
+
+TEST_F(ParamsHandleTest, assignmentInvalidates) {
+    param_handle<double> beta=par.handle<double>("beta");
+    par["beta"]=0.5;
+    EXPECT_EQ(0.5, *beta);
+    par["beta"]=1.5;
+    EXPECT_EQ(1.5, *beta);
+    // type change to a convertible type
+    par["beta"]=3;
+    EXPECT_EQ(3., *beta);
+}
+
+TEST_F(ParamsHandleTest, reassignmentInvalidates) {
+    param_handle<int> size=par.handle<int>("L");
+    alps::params other;
+    other["L"]=32;
+    par=other;
+    EXPECT_EQ(32, *size);
+
+    other["L"]=64;
+    swap(par, other);
+    EXPECT_EQ(64, *size);
+
+    par.erase("L");
+    EXPECT_THROW(*size, de::uninitialized_value);
+}
+
+TEST_F(ParamsHandleTest, loadInvalidates) {
+    alps::testing::unique_file ufile("params_handle.h5.", alps::testing::unique_file::REMOVE_NOW);
+    alps::params other(par);
+    other["beta"]=4.;
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        ar["/parameters"] << other;
+    }
+    param_handle<double> beta=par.handle<double>("beta");
+    EXPECT_EQ(2.5, *beta);
+    {
+        alps::hdf5::archive ar(ufile.name(), "r");
+        ar["/parameters"] >> par;
+    }
+    EXPECT_EQ(4., *beta);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file params_large_vector.cpp
+
+    @brief Tests array-valued parameters with many elements
+*/
+
+#include "./params_test_support.hpp"
+
+#include <alps/testing/unique_file.hpp>
+
+#include <sstream>
+
+using alps::params;
+
+namespace {
+    const std::size_t LARGE_SIZE=200000;
+
+    /// Makes a comma-separated list of `n` integers, the result is much longer than a "usual" line
+    std::string make_int_list(std::size_t n) {
+        std::ostringstream out;
+        for (std::size_t i=0; i<n; ++i) {
+            if (i) out << ",";
+            out << 3*i+1;
+        }
+        return out.str();
+    }
+
+    void check_int_list(const std::vector<int>& vec, std::size_t n) {
+        ASSERT_EQ(n, vec.size());
+        for (std::size_t i=0; i<n; ++i) {
+            ASSERT_EQ(int(3*i+1), vec[i]) << "i=" << i;
+        }
+    }
+}
+
+TEST(ParamsLargeVectorTest, iniFile) {
+    ini_maker ini("params_large_vector.ini.");
+    ini.add("before=1")
+       .add("int_vec="+make_int_list(LARGE_SIZE))
+       .add("[section]")
+       .add("double_vec=0.5,1.5,\\")
+       .add(make_int_list(1000)+",\\")
+       .add("2.5")
+       .add("after=2");
+
+    params p(ini.name());
+    p.define< std::vector<int> >("int_vec", "Large vector")
+     .define< std::vector<double> >("section.double_vec", "Continued vector")
+     .define<int>("before", "Parameter before the large vector")
+     .define<int>("section.after", "Parameter after the large vector");
+    ASSERT_TRUE(p.ok());
+
+    check_int_list(p["int_vec"].as< std::vector<int> >(), LARGE_SIZE);
+    const std::vector<double> dvec=p["section.double_vec"];
+    ASSERT_EQ(1003u, dvec.size());
+    EXPECT_EQ(1.5, dvec[1]);
+    EXPECT_EQ(2998., dvec[1001]);
+    EXPECT_EQ(2.5, dvec[1002]);
+    EXPECT_EQ(1, p["before"].as<int>());
+    EXPECT_EQ(2, p["section.after"].as<int>());
+}
+
+TEST(ParamsLargeVectorTest, commandLine) {
+    arg_holder args;
+    args.add("int_vec="+make_int_list(LARGE_SIZE));
+    params p(args.argc(), args.argv());
+    p.define< std::vector<int> >("int_vec", "Large vector");
+    ASSERT_TRUE(p.ok());
+    check_int_list(p["int_vec"].as< std::vector<int> >(), LARGE_SIZE);
+}
+
+TEST(ParamsLargeVectorTest, elementErrors) {
+    arg_holder args;
+    args
+        .add("empty_elem=1,,2")
+        .add("leading_comma=,1")
+        .add("trailing_comma=1,2,")
+        .add("not_int=1,1.5")
+        .add("strings=AAA,,B");
+    params p(args.argc(), args.argv());
+    p.define< std::vector<int> >("empty_elem", "Empty element")
+     .define< std::vector<int> >("leading_comma", "Empty first element")
+     .define< std::vector<int> >("trailing_comma", "Trailing comma is ignored")
+     .define< std::vector<int> >("not_int", "Element of a wrong type")
+     .define< std::vector<std::string> >("strings", "Empty string element");
+
+    EXPECT_FALSE(p.ok());
+    EXPECT_FALSE(p.exists("empty_elem"));
+    EXPECT_FALSE(p.exists("leading_comma"));
+    EXPECT_FALSE(p.exists("not_int"));
+
+    const std::vector<int> tc=p["trailing_comma"];
+    ASSERT_EQ(2u, tc.size());
+    EXPECT_EQ(2, tc[1]);
+
+    const std::vector<std::string> strs=p["strings"];
+    ASSERT_EQ(3u, strs.size());
+    EXPECT_EQ("", strs[1]);
+}
+
+TEST(ParamsLargeVectorTest, saveLoad) {
+    alps::testing::unique_file ufile("params_large_vector.h5.", alps::testing::unique_file::REMOVE_NOW);
+    arg_holder args;
+    args.add("int_vec="+make_int_list(LARGE_SIZE));
+    params p(args.argc(), args.argv());
+    p.define< std::vector<int> >("int_vec", "Large vector");
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        ar["/parameters"] << p;
+    }
+    params p_loaded;
+    {
+        alps::hdf5::archive ar(ufile.name(), "r");
+        ar["/parameters"] >> p_loaded;
+    }
+    EXPECT_TRUE(p==p_loaded);
+    check_int_list(p_loaded["int_vec"].as< std::vector<int> >(), LARGE_SIZE);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file params_sweep.cpp
+
+    @brief Tests expansion of parameter sweeps
+*/
+
+#include "./params_test_support.hpp"
+
+#include <alps/params/params_sweep.hpp>
+
+using alps::params;
+using alps::params_ns::params_sweep;
+namespace de=alps::params_ns::exception;
+
+namespace test_data {
+    static const char inifile_content[]=
+        "beta = linspace(1, 2, 5)\n"
+        "model = list(ising, heisenberg)\n"
+        "seed = 42\n"
+        "[lattice]\n"
+        "L = range(8, 32, 8)\n"
+        ;
+}
+
+class ParamsSweepTest : public ::testing::Test {
+  protected:
+    ParamsAndFile params_and_file_;
+    const params& par_;
+
+  public:
+    ParamsSweepTest() : params_and_file_(::test_data::inifile_content),
+                        par_(*params_and_file_.get_params_ptr())
+    { }
+};
+
+TEST_F(ParamsSweepTest, cartesian) {
+    params_sweep sweep(par_);
+    ASSERT_EQ(5u*2u*3u, sweep.size());
+    std::vector<std::string> keys=sweep.keys();
+    ASSERT_EQ(3u, keys.size());
+    EXPECT_EQ("beta", keys[0]);
+    EXPECT_EQ("lattice.L", keys[1]);
+    EXPECT_EQ("model", keys[2]);
+
+    // the last key varies fastest
+    params p=sweep[13]; // beta[2], L[0], model[1]
+    p.define<double>("beta", "Inverse temperature")
+     .define<int>("lattice.L", "System size")
+     .define<std::string>("model", "Model")
+     .define<int>("seed", "Random seed");
+    ASSERT_TRUE(p.ok());
+    EXPECT_EQ(1.5, p["beta"].as<double>());
+    EXPECT_EQ(8, p["lattice.L"].as<int>());
+    EXPECT_EQ("heisenberg", p["model"].as<std::string>());
+    EXPECT_EQ(42, p["seed"].as<int>());
+
+    EXPECT_EQ("2", sweep.value(sweep.size()-1, "beta"));
+    EXPECT_EQ("24", sweep.value(sweep.size()-1, "lattice.L"));
+    EXPECT_EQ("1.25", sweep.value(6, "beta"));
+    EXPECT_THROW(sweep.value(0, "seed"), de::uninitialized_value);
+    EXPECT_THROW(sweep[sweep.size()], std::out_of_range);
+}
+
+TEST_F(ParamsSweepTest, zip) {
+    EXPECT_THROW(params_sweep(par_, params_sweep::ZIP), de::value_mismatch);
+
+    arg_holder args;
+    args.add("beta=linspace(0.5, 1.5, 3)").add("L=list(4, 8, 16)").add("J=-1");
+    params par(args.argc(), args.argv());
+    params_sweep sweep(par, params_sweep::ZIP);
+    ASSERT_EQ(3u, sweep.size());
+    params p=sweep[1];
+    p.define<double>("beta", "").define<int>("L", "").define<double>("J", "");
+    ASSERT_TRUE(p.ok());
+    EXPECT_EQ(1., p["beta"].as<double>());
+    EXPECT_EQ(8, p["L"].as<int>());
+    EXPECT_EQ(-1., p["J"].as<double>());
+}
+
+TEST_F(ParamsSweepTest, noSweep) {
+    arg_holder args;
+    args.add("beta=2").add("name=f(x)");
+    params par(args.argc(), args.argv());
+    params_sweep sweep(par);
+    EXPECT_EQ(1u, sweep.size());
+    EXPECT_TRUE(sweep.keys().empty());
+    params p=sweep[0];
+    EXPECT_TRUE(p==par);
+}
+
+TEST_F(ParamsSweepTest, errors) {
+    {
+        arg_holder args;
+        args.add("beta=linspace(1, 2)");
+        EXPECT_THROW(params_sweep(params(args.argc(), args.argv())), de::value_mismatch);
+    }
+    {
+        arg_holder args;
+        args.add("beta=range(1, x)");
+        EXPECT_THROW(params_sweep(params(args.argc(), args.argv())), de::value_mismatch);
+    }
+    {
+        arg_holder args;
+        args.add("beta=range(2, 1)");
+        EXPECT_THROW(params_sweep(params(args.argc(), args.argv())), de::value_mismatch);
+    }
+    {
+        arg_holder args;
+        args.add("beta=list(1,,2)");
+        EXPECT_THROW(params_sweep(params(args.argc(), args.argv())), de::value_mismatch);
+    }
+    {
+        arg_holder args;
+        args.add("beta=list(1, 2)");
+        params par(args.argc(), args.argv());
+        par.define<double>("beta", "Inverse temperature");
+        EXPECT_THROW(params_sweep sweep(par), std::logic_error);
+    }
+}
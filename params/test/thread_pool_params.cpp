@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/params.hpp>
+#include <alps/params/thread_pool_params.hpp>
+
+#include <gtest/gtest.h>
+#include "./params_test_support.hpp"
+
+TEST(ThreadPoolParamsTest, Default)
+{
+    arg_holder args("progname");
+    alps::params p(args.argc(), args.argv());
+    alps::define_thread_pool_parameters(p);
+    EXPECT_EQ(0u, p["num_threads"].as<std::size_t>());
+
+    alps::configure_thread_pool(p);
+    const std::size_t env=alps::threading::environment_threads();
+    EXPECT_EQ(env>0 ? env : alps::threading::hardware_threads(), alps::threading::num_threads());
+}
+
+TEST(ThreadPoolParamsTest, Explicit)
+{
+    arg_holder args("progname");
+    args.add("num_threads=3");
+    alps::params p(args.argc(), args.argv());
+    alps::define_thread_pool_parameters(p);
+    alps::configure_thread_pool(p);
+    EXPECT_EQ(3u, alps::threading::num_threads());
+}
@@ -43,6 +43,14 @@ namespace alps {
 
         #undef ALPS_NUMERIC_OPERATOR_EQ
 
+        //------------------- fused in-place operations -------------------
+        /// Accumulates element-wise squares: sum += x*x, without temporaries
+        template<typename T, std::size_t N>
+        boost::array<T, N> & add_square(boost::array<T, N> & sum, boost::array<T, N> const & x) {
+            for (std::size_t i=0; i<N; ++i) sum[i]+=x[i]*x[i];
+            return sum;
+        }
+
         //------------------- infinity -------------------
         template<std::size_t N> struct inf<boost::array<double, N> > {
             operator boost::array<double, N> const() {
@@ -25,8 +25,10 @@
 #include <boost/throw_exception.hpp>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 
 #include <vector>
+#include <complex>
 #include <algorithm>
 #include <cmath>
 #include <stdexcept>
@@ -321,20 +323,72 @@ namespace alps {
         };
 
         
+        namespace detail {
+            /// True for element types the in-place kernels below are (auto-)vectorized for
+            template <typename T> struct is_simd_type : public boost::false_type {};
+            template <> struct is_simd_type<float> : public boost::true_type {};
+            template <> struct is_simd_type<double> : public boost::true_type {};
+            template <> struct is_simd_type< std::complex<float> > : public boost::true_type {};
+            template <> struct is_simd_type< std::complex<double> > : public boost::true_type {};
+
+            /// Throws if the vectors have different sizes
+            template <typename T, typename U>
+            void check_same_size(std::vector<T> const & lhs, std::vector<U> const & rhs) {
+                if(lhs.size() != rhs.size()) {
+                    std::string lsz=boost::lexical_cast<std::string>(lhs.size());
+                    std::string rsz=boost::lexical_cast<std::string>(rhs.size());
+                    boost::throw_exception(std::runtime_error("std::vectors have different sizes:"
+                                                              " left="+lsz+
+                                                              " right="+rsz + "\n" +
+                                                              ALPS_STACKTRACE));
+                }
+            }
+
+            // The kernels below are plain loops over raw arrays, with
+            // the native operators inlined, so that the compiler emits
+            // SIMD code for them; they do not allocate.
+
+            /// lhs[i] = op(lhs[i], rhs[i])
+            template <typename T, typename OP>
+            void apply_kernel(T* lhs, const T* rhs, std::size_t n, OP op) {
+                for (std::size_t i=0; i<n; ++i) lhs[i]=op(lhs[i], rhs[i]);
+            }
+
+            /// lhs[i] *= scalar
+            template <typename T>
+            void scale_kernel(T* lhs, const T scalar, std::size_t n) {
+                for (std::size_t i=0; i<n; ++i) lhs[i]*=scalar;
+            }
+
+            /// y[i] += a*x[i]
+            template <typename T>
+            void axpy_kernel(T* y, const T a, const T* x, std::size_t n) {
+                for (std::size_t i=0; i<n; ++i) y[i]+=a*x[i];
+            }
+
+            /// sum[i] += x[i]*x[i]
+            template <typename T>
+            void add_square_kernel(T* sum, const T* x, std::size_t n) {
+                for (std::size_t i=0; i<n; ++i) sum[i]+=x[i]*x[i];
+            }
+        }
+
         //------------------- operator equal -------------------
         #define ALPS_NUMERIC_OPERATOR_EQ(OP_NAME, OPERATOR)                                                \
-            template<typename T>                                                                           \
-            std::vector<T> & OP_NAME (std::vector<T> & lhs, std::vector<T> const & rhs) {                  \
-                if(lhs.size() != rhs.size()) {                                                             \
-                    std::string lsz=boost::lexical_cast<std::string>(lhs.size());                          \
-                    std::string rsz=boost::lexical_cast<std::string>(rhs.size());                          \
-                    boost::throw_exception(std::runtime_error("std::vectors have different sizes:"         \
-                                                              " left="+lsz+                                \
-                                                              " right="+rsz + "\n" +                       \
-                                                              ALPS_STACKTRACE));                           \
+            namespace detail {                                                                             \
+                template<typename T>                                                                       \
+                void OPERATOR ## _in_place(std::vector<T> & lhs, std::vector<T> const & rhs, boost::true_type) { \
+                    if (!lhs.empty()) apply_kernel(&lhs[0], &rhs[0], lhs.size(), std:: OPERATOR <T>()); \
                 }                                                                                          \
-                else                                                                                       \
+                template<typename T>                                                                       \
+                void OPERATOR ## _in_place(std::vector<T> & lhs, std::vector<T> const & rhs, boost::false_type) { \
                     std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), OPERATOR <T,T,T>() ); \
+                }                                                                                          \
+            }                                                                                              \
+            template<typename T>                                                                           \
+            std::vector<T> & OP_NAME (std::vector<T> & lhs, std::vector<T> const & rhs) {                  \
+                detail::check_same_size(lhs, rhs);                                                         \
+                detail::OPERATOR ## _in_place(lhs, rhs, typename detail::is_simd_type<T>::type());         \
                 return lhs;                                                                                \
             }
 
@@ -344,8 +398,80 @@ namespace alps {
         ALPS_NUMERIC_OPERATOR_EQ(operator/=, divides)
 
         #undef ALPS_NUMERIC_OPERATOR_EQ
-        
-        
+
+        //------------------- operator equal with scalar -------------------
+        namespace detail {
+            template<typename T>
+            void scale_in_place(std::vector<T> & lhs, T const & scalar, boost::true_type) {
+                if (!lhs.empty()) scale_kernel(&lhs[0], scalar, lhs.size());
+            }
+            template<typename T>
+            void scale_in_place(std::vector<T> & lhs, T const & scalar, boost::false_type) {
+                for (std::size_t i=0; i<lhs.size(); ++i) lhs[i]*=scalar;
+            }
+        }
+
+        /// Scales a vector by a scalar, in place
+        template<typename T>
+        std::vector<T> & operator *= (std::vector<T> & lhs, T const & scalar) {
+            detail::scale_in_place(lhs, scalar, typename detail::is_simd_type<T>::type());
+            return lhs;
+        }
+
+        /// Divides a vector by a scalar, in place
+        template<typename T>
+        std::vector<T> & operator /= (std::vector<T> & lhs, T const & scalar) {
+            for (std::size_t i=0; i<lhs.size(); ++i) lhs[i]/=scalar;
+            return lhs;
+        }
+
+        //------------------- fused in-place operations -------------------
+        /// Adds a scaled value: y += a*x (for scalars)
+        template<typename T>
+        T & axpy(T & y, T const & a, T const & x) {
+            y+=a*x;
+            return y;
+        }
+
+        /// Adds a scaled vector: y += a*x, without temporaries
+        /** @throws std::runtime_error if the vectors have different sizes */
+        template<typename T>
+        std::vector<T> & axpy(std::vector<T> & y, T const & a, std::vector<T> const & x) {
+            detail::check_same_size(y, x);
+            if (!y.empty()) detail::axpy_kernel(&y[0], a, &x[0], y.size());
+            return y;
+        }
+
+        /// Accumulates a square: sum += x*x (for scalars)
+        template<typename T>
+        T & add_square(T & sum, T const & x) {
+            sum+=x*x;
+            return sum;
+        }
+
+        template<typename T>
+        std::vector<T> & add_square(std::vector<T> & sum, std::vector<T> const & x);
+
+        namespace detail {
+            template<typename T>
+            void add_square_in_place(std::vector<T> & sum, std::vector<T> const & x, boost::true_type) {
+                if (!sum.empty()) add_square_kernel(&sum[0], &x[0], sum.size());
+            }
+            template<typename T>
+            void add_square_in_place(std::vector<T> & sum, std::vector<T> const & x, boost::false_type) {
+                for (std::size_t i=0; i<sum.size(); ++i) add_square(sum[i], x[i]);
+            }
+        }
+
+        /// Accumulates element-wise squares: sum += x*x, without temporaries
+        /** @throws std::runtime_error if the vectors have different sizes */
+        template<typename T>
+        std::vector<T> & add_square(std::vector<T> & sum, std::vector<T> const & x) {
+            detail::check_same_size(sum, x);
+            detail::add_square_in_place(sum, x, typename detail::is_simd_type<T>::type());
+            return sum;
+        }
+
         /// Vector merge.
         /** Adds two vectors, possibly of different length, extending longer one with zeros to the right.
             Addition uses ``operator+``, therefore element lengths must match.
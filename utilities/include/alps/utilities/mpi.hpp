@@ -24,20 +24,81 @@
 #include <exception> /* for std::uncaught_exception() */
 #include <functional> /* for std::plus */
 #include <algorithm> /* for std::max */
+#include <climits> /* for INT_MAX */
+#include <cstddef> /* for std::ptrdiff_t */
 
 #include <boost/scoped_array.hpp> /* for std::string broadcast */
 #include <boost/shared_ptr.hpp> /* for proper copy/assign of managed communicators */
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
 
 #include <stdexcept>
 #include <typeinfo>
 
+// MPI-3 provides the C++ complex types in the C interface
+#if defined(MPI_VERSION) && MPI_VERSION>=3
+#ifndef ALPS_MPI_HAS_MPI_CXX_FLOAT_COMPLEX
+#define ALPS_MPI_HAS_MPI_CXX_FLOAT_COMPLEX
+#endif
+#ifndef ALPS_MPI_HAS_MPI_CXX_DOUBLE_COMPLEX
+#define ALPS_MPI_HAS_MPI_CXX_DOUBLE_COMPLEX
+#endif
+#ifndef ALPS_MPI_HAS_MPI_CXX_LONG_DOUBLE_COMPLEX
+#define ALPS_MPI_HAS_MPI_CXX_LONG_DOUBLE_COMPLEX
+#endif
+#endif
+
+#ifndef ALPS_MPI_CHUNK_BYTES
+/// Largest message (in bytes) sent by a single MPI call of the array operations
+/** Larger arrays are transferred by several MPI calls, so that element counts
+    never overflow the `int` count of MPI, and a huge transfer is pipelined in
+    chunks of a bandwidth-friendly size. Can be redefined before including this
+    header, but must be the same for all processes.
+*/
+#define ALPS_MPI_CHUNK_BYTES (1<<28)
+#endif
+
 
 namespace alps {
     namespace mpi {
 
         namespace detail {
-        /// Translate C++ primitive type into corresponding MPI type
-        template <typename T> class mpi_type {};
+        /// Creates (once) the MPI datatype for a trivially copyable type `T` not known to MPI: a block of bytes
+        template <typename T>
+        class byte_block_type {
+            static MPI_Datatype create() {
+                MPI_Datatype dtype;
+                MPI_Type_contiguous(sizeof(T), MPI_BYTE, &dtype);
+                MPI_Type_commit(&dtype);
+                return dtype;
+            }
+          public:
+            static MPI_Datatype get() {
+                static const MPI_Datatype dtype=create();
+                return dtype;
+            }
+        };
+
+        /// Translate C++ type into corresponding MPI type
+        /** Trivially copyable types (e.g., structures of numbers)
+            without a predefined MPI type are transferred as derived
+            datatypes; they can be reduced only with user-defined
+            operations (see `is_mpi_op`).
+        */
+        template <typename T> class mpi_type {
+          public:
+            typedef T value_type;
+            operator MPI_Datatype() {
+                BOOST_STATIC_ASSERT_MSG(boost::has_trivial_copy<T>::value && boost::has_trivial_destructor<T>::value,
+                                        "Only trivially copyable types can be transferred by MPI");
+                return byte_block_type<T>::get();
+            }
+        };
+
+        /// True for C++ types that have a predefined MPI type
+        template <typename T> struct is_predefined_mpi_type : public boost::false_type {};
 
 #define ALPS_MPI_DETAIL_MAKETYPE(_mpitype_, _cxxtype_)          \
         template <>                                             \
@@ -45,7 +106,9 @@ namespace alps {
           public:                                               \
             typedef _cxxtype_ value_type;                       \
             operator MPI_Datatype() { return _mpitype_; }       \
-        }
+        };                                                      \
+        template <>                                             \
+        struct is_predefined_mpi_type<_cxxtype_> : public boost::true_type {}
 
         ALPS_MPI_DETAIL_MAKETYPE(MPI_CHAR,char);
         ALPS_MPI_DETAIL_MAKETYPE(MPI_SHORT,signed short int);
@@ -62,16 +125,11 @@ namespace alps {
         ALPS_MPI_DETAIL_MAKETYPE(MPI_FLOAT,float);
         ALPS_MPI_DETAIL_MAKETYPE(MPI_DOUBLE,double);
         ALPS_MPI_DETAIL_MAKETYPE(MPI_LONG_DOUBLE,long double);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_WCHAR,wchar_t);
+        ALPS_MPI_DETAIL_MAKETYPE(MPI_WCHAR,wchar_t);
         // ALPS_MPI_DETAIL_MAKETYPE(MPI_C_BOOL,_Bool);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_INT8_T,int8_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_INT16_T,int16_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_INT32_T,int32_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_INT64_T,int64_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_UINT8_T,uint8_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_UINT16_T,uint16_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_UINT32_T,uint32_t);
-        // ALPS_MPI_DETAIL_MAKETYPE(MPI_UINT64_T,uint64_t);
+        // NOTE: The fixed-width integer types (`int8_t`...`uint64_t`) are
+        //       typedefs of the standard integer types above, hence need no
+        //       (and may not have) separate entries.
         // ALPS_MPI_DETAIL_MAKETYPE(MPI_C_COMPLEX,float _Complex);
         // ALPS_MPI_DETAIL_MAKETYPE(MPI_C_FLOAT_COMPLEX,float _Complex);
         // ALPS_MPI_DETAIL_MAKETYPE(MPI_C_DOUBLE_COMPLEX,double _Complex);
@@ -84,8 +142,32 @@ namespace alps {
         ALPS_MPI_DETAIL_MAKETYPE(MPI_CXX_DOUBLE_COMPLEX,std::complex<double>);
         ALPS_MPI_DETAIL_MAKETYPE(MPI_CXX_FLOAT_COMPLEX,std::complex<float>);
 #endif
+#ifdef ALPS_MPI_HAS_MPI_CXX_LONG_DOUBLE_COMPLEX
+        ALPS_MPI_DETAIL_MAKETYPE(MPI_CXX_LONG_DOUBLE_COMPLEX,std::complex<long double>);
+#endif
 
 #undef ALPS_MPI_DETAIL_MAKETYPE
+
+        /// Number of array elements of `elem_size` bytes each transferred by a single MPI call
+        inline std::size_t chunk_length(std::size_t elem_size) {
+            BOOST_STATIC_ASSERT_MSG(ALPS_MPI_CHUNK_BYTES>0 && ALPS_MPI_CHUNK_BYTES<=INT_MAX, "Invalid value of ALPS_MPI_CHUNK_BYTES");
+            const std::size_t len=ALPS_MPI_CHUNK_BYTES/elem_size;
+            return len>0 ? len : 1;
+        }
+
+        /// Broadcasts `count` elements of `elem_size` bytes, each made of `type_count` values of MPI type `type`
+        inline void chunked_broadcast(void* vals, std::size_t count, std::size_t elem_size,
+                                      MPI_Datatype type, int type_count, int root, MPI_Comm comm)
+        {
+            char* ptr=static_cast<char*>(vals);
+            const std::size_t chunk=chunk_length(elem_size);
+            while (count>0) {
+                const std::size_t len=std::min(count, chunk);
+                MPI_Bcast(ptr, int(len)*type_count, type, root, comm);
+                ptr+=len*elem_size;
+                count-=len;
+            }
+        }
         } // detail::
 
 
@@ -201,6 +283,26 @@ namespace alps {
                 }
             }
 
+            /// Initializes MPI requesting the thread support `required_thread_level` (e.g., `MPI_THREAD_FUNNELED`)
+            /** The level actually provided is returned by `thread_level()`. */
+            environment(int& argc, char**& argv, int required_thread_level, bool abort_on_exception=true)
+                : initialized_(false), abort_on_exception_(abort_on_exception)
+            {
+                if (!initialized()) {
+                    int provided;
+                    MPI_Init_thread(&argc, &argv, required_thread_level, &provided);
+                    initialized_=true;
+                }
+            }
+
+            /// Returns the level of thread support provided by MPI
+            static int thread_level()
+            {
+                int provided;
+                MPI_Query_thread(&provided);
+                return provided;
+            }
+
             ~environment()
             {
                 if (!initialized_) return; // we are not in control, don't mess up other's logic.
@@ -228,14 +330,14 @@ namespace alps {
         /// Broadcasts array `vals` of a primitive type `T`, length `count` on communicator `comm` with root `root`
         template <typename T>
         void broadcast(const communicator& comm, T* vals, std::size_t count, int root) {
-            MPI_Bcast(vals, count, detail::mpi_type<T>(), root, comm);
+            detail::chunked_broadcast(vals, count, sizeof(T), detail::mpi_type<T>(), 1, root, comm);
         }
 
 #ifndef ALPS_MPI_HAS_MPI_CXX_BOOL
         /// MPI_BCast of an array: overload for bool
         inline void broadcast(const communicator& comm, bool* vals, std::size_t count, int root) {
             // sizeof() returns size in chars (FIXME? should it be bytes?)
-            MPI_Bcast(vals, count*sizeof(bool), MPI_CHAR, root, comm);
+            detail::chunked_broadcast(vals, count, sizeof(bool), MPI_CHAR, sizeof(bool), root, comm);
         }
 #endif /* ALPS_MPI_HAS_MPI_BOOL */
 
@@ -245,7 +347,7 @@ namespace alps {
         template <typename T>
         inline void broadcast(const communicator& comm, std::complex<T>* vals, std::size_t count, int root) {
             // sizeof() returns size in chars (FIXME? should it be bytes?)
-            MPI_Bcast(vals, count*sizeof(std::complex<T>), MPI_CHAR, root, comm);
+            detail::chunked_broadcast(vals, count, sizeof(std::complex<T>), MPI_CHAR, sizeof(std::complex<T>), root, comm);
         }
 #endif
 
@@ -290,40 +392,65 @@ namespace alps {
                           comm);
         }
 
+        namespace detail {
+            /// User-defined MPI reduction operation applying (commutative) functor `OP` to values of type `T`
+            template <typename OP, typename T>
+            class user_mpi_op {
+                static void apply(void* invec, void* inoutvec, int* len, MPI_Datatype*) {
+                    const T* in=static_cast<const T*>(invec);
+                    T* inout=static_cast<T*>(inoutvec);
+                    OP op;
+                    for (int i=0; i<*len; ++i) inout[i]=op(in[i], inout[i]);
+                }
+
+                static MPI_Op create() {
+                    MPI_Op op;
+                    MPI_Op_create(&apply, 1, &op);
+                    return op;
+                }
+              public:
+                /// Creates (once) the MPI operation
+                static MPI_Op get() {
+                    static const MPI_Op op=create();
+                    return op;
+                }
+            };
+        } // detail::
+
         /// Trait for MPI reduction operations
-        // FIXME: remove T? or just ensure it's a basic MPI type?
+        /** For types without predefined MPI operations, the functor `OP`
+            (which must be commutative and default-constructible) is wrapped
+            into a user-defined MPI operation.
+        */
         template <typename OP, typename T>
         class is_mpi_op {
             public:
             static MPI_Op op() {
-                throw std::logic_error(std::string("is_mpi_op() is not implemented, called for types OP=")
-                                       +typeid(OP).name() + " and T="+typeid(T).name());
+                return detail::user_mpi_op<OP,T>::get();
             }
         };
 
         /// Trait for MPI reduction operations: specialization for addition
-        // FIXME: remove T? restrict T?
         template <typename T>
         class is_mpi_op<std::plus<T>, T> {
             public:
             static MPI_Op op() {
-                return MPI_SUM;
+                return detail::is_predefined_mpi_type<T>::value ? MPI_SUM : detail::user_mpi_op<std::plus<T>,T>::get();
             }
         };
 
         /// Trait for MPI reduction operations: specialization for maximum
-        // FIXME: remove T? restrict T?
         template <typename T>
         class is_mpi_op<maximum<T>, T> {
             public:
             static MPI_Op op() {
-                return MPI_MAX;
+                return detail::is_predefined_mpi_type<T>::value ? MPI_MAX : detail::user_mpi_op<maximum<T>,T>::get();
             }
         };
 
         /// Performs MPI_Allreduce for array of a primitive type, T[n]
         template <typename T, typename OP>
-        void all_reduce(const alps::mpi::communicator& comm, const T* val, int n,
+        void all_reduce(const alps::mpi::communicator& comm, const T* val, std::ptrdiff_t n,
                         T* out_val, const OP& /*op*/)
         {
             if (n<=0) {
@@ -333,8 +460,13 @@ namespace alps {
             if (val==out_val) {
                 throw std::invalid_argument("Implicit in-place mpi::all_reduce() is not implemented");
             }
-            MPI_Allreduce(const_cast<T*>(val), out_val, n, detail::mpi_type<T>(),
-                          is_mpi_op<OP,T>::op(), comm);
+            const std::size_t count=n;
+            const std::size_t chunk=detail::chunk_length(sizeof(T));
+            for (std::size_t offset=0; offset<count; offset+=chunk) {
+                const int len=std::min(count-offset, chunk);
+                MPI_Allreduce(const_cast<T*>(val+offset), out_val+offset, len, detail::mpi_type<T>(),
+                              is_mpi_op<OP,T>::op(), comm);
+            }
         }
 
         /// Performs MPI_Allreduce for a primitive type T
@@ -354,6 +486,75 @@ namespace alps {
             return out_val;
         }
 
+        /// Performs MPI_Reduce for array of a primitive type, T[n]; `out_val` is used on the root only
+        template <typename T, typename OP>
+        void reduce(const alps::mpi::communicator& comm, const T* val, std::ptrdiff_t n,
+                    T* out_val, const OP& /*op*/, int root)
+        {
+            if (n<=0) {
+                throw std::invalid_argument("Non-positive array size in mpi::reduce()");
+            }
+            if (val==out_val) {
+                throw std::invalid_argument("Implicit in-place mpi::reduce() is not implemented");
+            }
+            const bool is_root=(comm.rank()==root);
+            const std::size_t count=n;
+            const std::size_t chunk=detail::chunk_length(sizeof(T));
+            for (std::size_t offset=0; offset<count; offset+=chunk) {
+                const int len=std::min(count-offset, chunk);
+                MPI_Reduce(const_cast<T*>(val+offset), is_root ? out_val+offset : 0, len, detail::mpi_type<T>(),
+                           is_mpi_op<OP,T>::op(), root, comm);
+            }
+        }
+
+        /// Performs MPI_Reduce for array of a primitive type, T[n], on a non-root process
+        template <typename T, typename OP>
+        void reduce(const alps::mpi::communicator& comm, const T* val, std::ptrdiff_t n,
+                    const OP& op, int root)
+        {
+            if (comm.rank()==root) {
+                throw std::logic_error("mpi::reduce() without the output array is called on the root process");
+            }
+            reduce(comm, val, n, static_cast<T*>(0), op, root);
+        }
+
+        /// Performs MPI_Gather for arrays of a primitive type, T[n], from each process
+        /** @param out_vals array of `n*comm.size()` values, receives the arrays in the order of ranks;
+                   used on the root only
+        */
+        template <typename T>
+        void gather(const alps::mpi::communicator& comm, const T* in_vals, std::ptrdiff_t n,
+                    T* out_vals, int root)
+        {
+            if (n<=0) {
+                throw std::invalid_argument("Non-positive array size in mpi::gather()");
+            }
+            const bool is_root=(comm.rank()==root);
+            const std::size_t count=n;
+            // the root receives `comm.size()` pieces of a chunk in each call
+            const std::size_t chunk=detail::chunk_length(sizeof(T)*comm.size());
+            if (count<=chunk) {
+                MPI_Gather(const_cast<T*>(in_vals), n, detail::mpi_type<T>(),
+                           out_vals, n, detail::mpi_type<T>(), root, comm);
+                return;
+            }
+            for (std::size_t offset=0; offset<count; offset+=chunk) {
+                const int len=std::min(count-offset, chunk);
+                // on the root, a piece of a chunk is placed `n` elements after the piece from the previous rank
+                MPI_Datatype recv_type=detail::mpi_type<T>();
+                if (is_root) {
+                    MPI_Datatype piece_type;
+                    MPI_Type_contiguous(len, detail::mpi_type<T>(), &piece_type);
+                    MPI_Type_create_resized(piece_type, 0, MPI_Aint(count*sizeof(T)), &recv_type);
+                    MPI_Type_commit(&recv_type);
+                    MPI_Type_free(&piece_type);
+                }
+                MPI_Gather(const_cast<T*>(in_vals+offset), len, detail::mpi_type<T>(),
+                           is_root ? out_vals+offset : 0, 1, recv_type, root, comm);
+                if (is_root) MPI_Type_free(&recv_type);
+            }
+        }
+
     } // mpi::
 } // alps::
 
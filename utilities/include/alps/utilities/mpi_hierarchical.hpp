@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_hierarchical.hpp
+
+    @brief Header for node-aware (two-level) reductions
+
+    @details
+    A reduction over many processes per node first sums the data of
+    each node onto its leader (through the shared memory of the node),
+    and only then reduces among the node leaders; the traffic between
+    nodes shrinks by the number of processes per node.
+
+    The node structure of a communicator (`node_topology`) is obtained
+    with `MPI_Comm_split_type()` once and cached as an attribute of the
+    communicator.  Whether `node_aware_reduce()` takes the two-level path
+    is controlled by `set_reduction_mode()`, or by the environment
+    variable `ALPS_MPI_REDUCTION` (`flat`, `node` or `auto`); by default
+    (`auto`) it does so when the communicator spans several nodes, some
+    of them with several processes.
+*/
+
+#ifndef ALPS_UTILITIES_MPI_HIERARCHICAL_HPP_INCLUDED_3f9d2b6a81c54e0f9a7b5d1c2e86f430
+#define ALPS_UTILITIES_MPI_HIERARCHICAL_HPP_INCLUDED_3f9d2b6a81c54e0f9a7b5d1c2e86f430
+
+#include <alps/utilities/mpi.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace alps {
+    namespace mpi {
+
+        /// Ways to perform reductions
+        enum reduction_mode {
+            flat_reduction,      ///< plain `MPI_Reduce()` over the communicator
+            node_reduction,      ///< within the nodes first, then among the node leaders
+            automatic_reduction  ///< node-aware if the communicator spans several multi-process nodes
+        };
+
+        namespace detail {
+            inline reduction_mode initial_reduction_mode() {
+                const char* env=std::getenv("ALPS_MPI_REDUCTION");
+                if (!env) return automatic_reduction;
+                if (std::strcmp(env, "flat")==0) return flat_reduction;
+                if (std::strcmp(env, "node")==0) return node_reduction;
+                return automatic_reduction;
+            }
+
+            inline reduction_mode& current_reduction_mode() {
+                static reduction_mode mode=initial_reduction_mode();
+                return mode;
+            }
+        } // detail::
+
+        /// Returns the way reductions are performed
+        inline reduction_mode get_reduction_mode() { return detail::current_reduction_mode(); }
+
+        /// Sets the way reductions are performed; must be the same on all processes
+        inline void set_reduction_mode(reduction_mode mode) { detail::current_reduction_mode()=mode; }
+
+#if defined(MPI_VERSION) && MPI_VERSION>=3
+
+        /// Node structure of a communicator: the processes sharing memory, and one leader per node
+        /** The leader of a node is its process of the lowest rank (so rank 0
+            always leads); the nodes are numbered by the ranks of their
+            leaders among the leaders.
+        */
+        class node_topology {
+            communicator node_;
+            communicator leaders_;
+            int rank_;
+            int num_nodes_;
+            std::vector<int> node_of_;
+            std::vector<int> node_rank_of_;
+
+            // Functor to release a cached topology (called by MPI when the communicator is freed)
+            static int delete_attr(MPI_Comm, int, void* attr, void*) {
+                delete static_cast<node_topology*>(attr);
+                return MPI_SUCCESS;
+            }
+
+            static int keyval() {
+                static int key=MPI_KEYVAL_INVALID;
+                if (key==MPI_KEYVAL_INVALID) {
+                    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, &delete_attr, &key, 0);
+                }
+                return key;
+            }
+
+            // Finds the leaders and numbers the nodes, given `node_`
+            void init_(const communicator& comm) {
+                MPI_Comm leaders_comm;
+                MPI_Comm_split(comm, (is_leader() ? 0 : MPI_UNDEFINED), rank_, &leaders_comm);
+                leaders_=(leaders_comm==MPI_COMM_NULL)
+                    ? communicator(MPI_COMM_SELF, comm_attach) // not used
+                    : communicator(leaders_comm, take_ownership);
+
+                int mine[2]={ (is_leader() ? leaders_.rank() : 0), node_.rank() };
+                MPI_Bcast(&mine[0], 1, MPI_INT, 0, node_);
+                std::vector<int> all(2*node_of_.size());
+                MPI_Allgather(mine, 2, MPI_INT, &all[0], 2, MPI_INT, comm);
+                for (std::size_t i=0; i<node_of_.size(); ++i) {
+                    node_of_[i]=all[2*i];
+                    node_rank_of_[i]=all[2*i+1];
+                    num_nodes_=std::max(num_nodes_, node_of_[i]+1);
+                }
+            }
+
+          public:
+            /// Determines the node structure of `comm` (collective)
+            explicit node_topology(const communicator& comm)
+                : node_(), leaders_(), rank_(comm.rank()), num_nodes_(0),
+                  node_of_(comm.size()), node_rank_of_(comm.size())
+            {
+                MPI_Comm node_comm;
+                MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank_, MPI_INFO_NULL, &node_comm);
+                node_=communicator(node_comm, take_ownership);
+                init_(comm);
+            }
+
+            /// Groups the processes of `comm` into "nodes" by `color` instead (collective)
+            /** Useful for other hierarchies (e.g., sockets) and for testing. */
+            node_topology(const communicator& comm, int color)
+                : node_(), leaders_(), rank_(comm.rank()), num_nodes_(0),
+                  node_of_(comm.size()), node_rank_of_(comm.size())
+            {
+                MPI_Comm node_comm;
+                MPI_Comm_split(comm, color, rank_, &node_comm);
+                node_=communicator(node_comm, take_ownership);
+                init_(comm);
+            }
+
+            /// Returns the topology of `comm`, determined on the first call and cached (collective on the first call)
+            static const node_topology& of(const communicator& comm) {
+                void* attr;
+                int found;
+                MPI_Comm_get_attr(comm, keyval(), &attr, &found);
+                if (found) return *static_cast<node_topology*>(attr);
+                node_topology* topo=new node_topology(comm);
+                MPI_Comm_set_attr(comm, keyval(), topo);
+                return *topo;
+            }
+
+            /// Processes on the node of this process
+            const communicator& node() const { return node_; }
+
+            /// Leaders of all nodes; meaningful on the leaders only
+            const communicator& leaders() const { return leaders_; }
+
+            /// Returns `true` if this process leads its node
+            bool is_leader() const { return node_.rank()==0; }
+
+            /// Rank of this process in the original communicator
+            int rank() const { return rank_; }
+
+            /// Number of nodes
+            int num_nodes() const { return num_nodes_; }
+
+            /// Number of processes in the original communicator
+            int size() const { return node_of_.size(); }
+
+            /// Node of the process `rank`
+            int node_of(int rank) const { return node_of_[rank]; }
+
+            /// Rank of the process `rank` within its node
+            int node_rank_of(int rank) const { return node_rank_of_[rank]; }
+        };
+
+        namespace detail {
+            /// Storage for `count` elements of `type` (on leaders that are not the root)
+            inline void* reduction_buffer(std::vector<char>& buffer, int count, MPI_Datatype type) {
+                MPI_Aint lb, extent;
+                MPI_Type_get_extent(type, &lb, &extent);
+                buffer.resize(std::size_t(count)*extent);
+                return buffer.empty() ? 0 : &buffer[0]-lb;
+            }
+        } // detail::
+
+        /// `MPI_Reduce()` in two levels: within the nodes, then among the node leaders
+        /** The arguments are the ones of `MPI_Reduce()`, including `MPI_IN_PLACE`
+            on the root; the operation must be commutative. If the root does not
+            lead its node, the result is passed on to it by its node leader.
+            @returns MPI error code
+        */
+        inline int node_aware_reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype type,
+                                     MPI_Op op, int root, const node_topology& topo)
+        {
+            const bool is_root=(topo.rank()==root);
+            const bool in_place=(is_root && sendbuf==MPI_IN_PLACE);
+            const int root_node=topo.node_of(root);
+            const int root_node_rank=topo.node_rank_of(root);
+            const bool in_root_node=(topo.node_of(topo.rank())==root_node);
+
+            // the sum over the node, kept by its leader
+            std::vector<char> buffer;
+            void* partial=0;
+            if (topo.is_leader()) {
+                partial=is_root ? recvbuf : detail::reduction_buffer(buffer, count, type);
+            }
+
+            int rc=MPI_SUCCESS;
+            if (topo.is_leader()) {
+                const void* own=(in_place ? MPI_IN_PLACE : sendbuf);
+                rc=MPI_Reduce(const_cast<void*>(own), partial, count, type, op, 0, topo.node());
+            } else {
+                const void* own=(in_place ? recvbuf : sendbuf);
+                rc=MPI_Reduce(const_cast<void*>(own), 0, count, type, op, 0, topo.node());
+            }
+            if (rc!=MPI_SUCCESS) return rc;
+
+            if (topo.is_leader() && topo.num_nodes()>1) {
+                if (in_root_node) {
+                    rc=MPI_Reduce(MPI_IN_PLACE, partial, count, type, op, root_node, topo.leaders());
+                } else {
+                    rc=MPI_Reduce(partial, 0, count, type, op, root_node, topo.leaders());
+                }
+                if (rc!=MPI_SUCCESS) return rc;
+            }
+
+            if (root_node_rank!=0 && in_root_node) {
+                const int tag=0;
+                if (topo.is_leader()) {
+                    rc=MPI_Send(partial, count, type, root_node_rank, tag, topo.node());
+                } else if (is_root) {
+                    rc=MPI_Recv(recvbuf, count, type, 0, tag, topo.node(), MPI_STATUS_IGNORE);
+                }
+            }
+            return rc;
+        }
+
+        /// `MPI_Allreduce()` in two levels: within the nodes, among the node leaders, and back to the nodes
+        /** The arguments are the ones of `MPI_Allreduce()`, including `MPI_IN_PLACE`.
+            @returns MPI error code
+        */
+        inline int node_aware_all_reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype type,
+                                         MPI_Op op, const node_topology& topo)
+        {
+            int rc;
+            if (topo.is_leader()) {
+                rc=MPI_Reduce(const_cast<void*>(sendbuf), recvbuf, count, type, op, 0, topo.node());
+                if (rc==MPI_SUCCESS && topo.num_nodes()>1) {
+                    rc=MPI_Allreduce(MPI_IN_PLACE, recvbuf, count, type, op, topo.leaders());
+                }
+            } else {
+                const void* own=(sendbuf==MPI_IN_PLACE ? recvbuf : sendbuf);
+                rc=MPI_Reduce(const_cast<void*>(own), 0, count, type, op, 0, topo.node());
+            }
+            if (rc!=MPI_SUCCESS) return rc;
+            return MPI_Bcast(recvbuf, count, type, 0, topo.node());
+        }
+
+#endif /* MPI-3 */
+
+        /// Returns `true` if reductions over `comm` take the node-aware path (collective)
+        inline bool use_node_reduction(const communicator& comm)
+        {
+#if defined(MPI_VERSION) && MPI_VERSION>=3
+            const reduction_mode mode=get_reduction_mode();
+            if (mode==flat_reduction) return false;
+            int is_inter;
+            MPI_Comm_test_inter(comm, &is_inter);
+            if (is_inter) return false;
+            if (mode==node_reduction) return true;
+            const node_topology& topo=node_topology::of(comm);
+            return topo.num_nodes()>1 && topo.num_nodes()<topo.size();
+#else
+            (void)comm;
+            return false;
+#endif
+        }
+
+        /// `MPI_Reduce()` taking the node-aware path when `use_node_reduction(comm)`
+        /** @returns MPI error code */
+        inline int node_aware_reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype type,
+                                     MPI_Op op, int root, const communicator& comm)
+        {
+#if defined(MPI_VERSION) && MPI_VERSION>=3
+            if (use_node_reduction(comm)) {
+                return node_aware_reduce(sendbuf, recvbuf, count, type, op, root, node_topology::of(comm));
+            }
+#endif
+            return MPI_Reduce(const_cast<void*>(sendbuf), recvbuf, count, type, op, root, comm);
+        }
+
+        /// `MPI_Allreduce()` taking the node-aware path when `use_node_reduction(comm)`
+        /** @returns MPI error code */
+        inline int node_aware_all_reduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype type,
+                                         MPI_Op op, const communicator& comm)
+        {
+#if defined(MPI_VERSION) && MPI_VERSION>=3
+            if (use_node_reduction(comm)) {
+                return node_aware_all_reduce(sendbuf, recvbuf, count, type, op, node_topology::of(comm));
+            }
+#endif
+            return MPI_Allreduce(const_cast<void*>(sendbuf), recvbuf, count, type, op, comm);
+        }
+
+        /// Reduces an array of a primitive type, T[n], onto the root, node-aware if enabled
+        /** `out_val` is used on the root only; `val==out_val` on the root reduces in place. */
+        template <typename T, typename OP>
+        void node_aware_reduce(const communicator& comm, const T* val, std::ptrdiff_t n,
+                               T* out_val, const OP& /*op*/, int root)
+        {
+            if (n<=0) {
+                throw std::invalid_argument("Non-positive array size in mpi::node_aware_reduce()");
+            }
+            const bool is_root=(comm.rank()==root);
+            const bool in_place=(is_root && val==out_val);
+            const std::size_t count=n;
+            const std::size_t chunk=detail::chunk_length(sizeof(T));
+            for (std::size_t offset=0; offset<count; offset+=chunk) {
+                const int len=std::min(count-offset, chunk);
+                node_aware_reduce((in_place ? MPI_IN_PLACE : val+offset), (is_root ? out_val+offset : 0), len,
+                                  detail::mpi_type<T>(), is_mpi_op<OP,T>::op(), root, comm);
+            }
+        }
+
+        /// All-reduces an array of a primitive type, T[n], node-aware if enabled; `val==out_val` reduces in place
+        template <typename T, typename OP>
+        void node_aware_all_reduce(const communicator& comm, const T* val, std::ptrdiff_t n,
+                                   T* out_val, const OP& /*op*/)
+        {
+            if (n<=0) {
+                throw std::invalid_argument("Non-positive array size in mpi::node_aware_all_reduce()");
+            }
+            const bool in_place=(val==out_val);
+            const std::size_t count=n;
+            const std::size_t chunk=detail::chunk_length(sizeof(T));
+            for (std::size_t offset=0; offset<count; offset+=chunk) {
+                const int len=std::min(count-offset, chunk);
+                node_aware_all_reduce((in_place ? MPI_IN_PLACE : val+offset), out_val+offset, len,
+                                      detail::mpi_type<T>(), is_mpi_op<OP,T>::op(), comm);
+            }
+        }
+
+    } // mpi::
+} // alps::
+
+#endif /* ALPS_UTILITIES_MPI_HIERARCHICAL_HPP_INCLUDED_3f9d2b6a81c54e0f9a7b5d1c2e86f430 */
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_nonblocking.hpp
+
+    @brief Header for nonblocking (MPI-3) collective operations
+
+    @details
+    Each operation starts the collective and returns an
+    `alps::mpi::request`; the buffers passed to the operation must
+    stay valid and must not be modified until the request is
+    completed by `wait()`, `wait_all()` or a successful `test()`.
+*/
+
+#ifndef ALPS_UTILITIES_MPI_NONBLOCKING_HPP_INCLUDED_5c0d2a7e9b3f4e18a6d1c4b7f2e9a803
+#define ALPS_UTILITIES_MPI_NONBLOCKING_HPP_INCLUDED_5c0d2a7e9b3f4e18a6d1c4b7f2e9a803
+
+#include <alps/utilities/mpi.hpp>
+
+#if !defined(MPI_VERSION) || MPI_VERSION<3
+#error "Nonblocking collective operations require MPI-3"
+#endif
+
+#include <vector>
+#include <complex>
+#include <stdexcept>
+#include <climits>
+
+#include <boost/shared_ptr.hpp>
+
+namespace alps {
+    namespace mpi {
+
+        namespace detail {
+            /// State of a pending operation: the MPI request and the data the operation needs until it completes
+            struct request_state {
+                MPI_Request req;
+                std::vector<int> aux; ///< e.g., counts and displacements of gatherv
+                request_state() : req(MPI_REQUEST_NULL), aux() {}
+            };
+
+            // Functor to complete (rather than leak) the operation when the last handle goes away
+            struct request_completer {
+                void operator()(request_state* state_ptr) {
+                    if (state_ptr->req!=MPI_REQUEST_NULL) {
+                        int finalized;
+                        MPI_Finalized(&finalized);
+                        if (!finalized) MPI_Wait(&state_ptr->req, MPI_STATUS_IGNORE);
+                    }
+                    delete state_ptr;
+                }
+            };
+
+            /// Checks the number of MPI items: unlike the blocking operations, a nonblocking one is never split in chunks
+            inline int nonblocking_count(std::size_t count) {
+                if (count>std::size_t(INT_MAX)) {
+                    throw std::invalid_argument("Array is too large for a nonblocking MPI operation");
+                }
+                return count;
+            }
+        } // detail::
+
+        /// Handle of a pending nonblocking operation
+        /** Copies of the object refer to the same operation. If the
+            operation is not completed when the last copy is destroyed,
+            the destructor waits for its completion (collective
+            operations cannot be cancelled).
+        */
+        class request {
+            boost::shared_ptr<detail::request_state> state_ptr_;
+
+          public:
+            /// Constructs an inactive (already completed) request
+            request() : state_ptr_(new detail::request_state(), detail::request_completer()) {}
+
+            /// True if the operation is not yet known to be completed
+            bool active() const { return state_ptr_->req!=MPI_REQUEST_NULL; }
+
+            /// Checks whether the operation is completed; does not block
+            bool test() {
+                int flag;
+                MPI_Test(&state_ptr_->req, &flag, MPI_STATUS_IGNORE);
+                return flag;
+            }
+
+            /// Blocks until the operation is completed
+            void wait() {
+                MPI_Wait(&state_ptr_->req, MPI_STATUS_IGNORE);
+            }
+
+            /// Access to the underlying MPI request (e.g., to start an operation)
+            MPI_Request* mpi_request() { return &state_ptr_->req; }
+
+            /// Storage for data that must outlive the start of the operation
+            std::vector<int>& aux() { return state_ptr_->aux; }
+        };
+
+        /// Blocks until all the operations are completed
+        inline void wait_all(std::vector<request>& reqs) {
+            if (reqs.empty()) return;
+            std::vector<MPI_Request> mpi_reqs(reqs.size());
+            for (std::size_t i=0; i<reqs.size(); ++i) mpi_reqs[i]=*reqs[i].mpi_request();
+            MPI_Waitall(mpi_reqs.size(), &mpi_reqs[0], MPI_STATUSES_IGNORE);
+            for (std::size_t i=0; i<reqs.size(); ++i) *reqs[i].mpi_request()=mpi_reqs[i];
+        }
+
+
+        /// Starts broadcast of array `vals` of a primitive type `T`, length `count`
+        template <typename T>
+        request ibroadcast(const communicator& comm, T* vals, std::size_t count, int root) {
+            request req;
+            MPI_Ibcast(vals, detail::nonblocking_count(count), detail::mpi_type<T>(), root, comm, req.mpi_request());
+            return req;
+        }
+
+#ifndef ALPS_MPI_HAS_MPI_CXX_BOOL
+        /// Starts broadcast of an array: overload for bool
+        inline request ibroadcast(const communicator& comm, bool* vals, std::size_t count, int root) {
+            request req;
+            MPI_Ibcast(vals, detail::nonblocking_count(count*sizeof(bool)), MPI_CHAR, root, comm, req.mpi_request());
+            return req;
+        }
+#endif /* ALPS_MPI_HAS_MPI_BOOL */
+
+#if !defined(ALPS_MPI_HAS_MPI_CXX_DOUBLE_COMPLEX) || !defined(ALPS_MPI_HAS_MPI_CXX_FLOAT_COMPLEX)
+        /// Starts broadcast of an array: overload for std::complex
+        template <typename T>
+        inline request ibroadcast(const communicator& comm, std::complex<T>* vals, std::size_t count, int root) {
+            request req;
+            MPI_Ibcast(vals, detail::nonblocking_count(count*sizeof(std::complex<T>)), MPI_CHAR, root, comm, req.mpi_request());
+            return req;
+        }
+#endif
+
+        /// Starts broadcast of value `val` of a primitive type `T`
+        template <typename T>
+        request ibroadcast(const communicator& comm, T& val, int root) {
+            return ibroadcast(comm, &val, 1, root);
+        }
+
+        /// Starts MPI_Iallreduce for array of a primitive type, T[n]
+        template <typename T, typename OP>
+        request iall_reduce(const communicator& comm, const T* val, int n, T* out_val, const OP& /*op*/)
+        {
+            if (n<=0) {
+                throw std::invalid_argument("Non-positive array size in mpi::iall_reduce()");
+            }
+            if (val==out_val) {
+                throw std::invalid_argument("Implicit in-place mpi::iall_reduce() is not implemented");
+            }
+            request req;
+            MPI_Iallreduce(const_cast<T*>(val), out_val, n, detail::mpi_type<T>(),
+                           is_mpi_op<OP,T>::op(), comm, req.mpi_request());
+            return req;
+        }
+
+        /// Starts MPI_Iallreduce for a primitive type T
+        template <typename T, typename OP>
+        request iall_reduce(const communicator& comm, const T& val, T& out_val, const OP& op)
+        {
+            return iall_reduce(comm, &val, 1, &out_val, op);
+        }
+
+        /// Starts MPI_Ireduce for array of a primitive type, T[n]; `out_val` is used on the root only
+        template <typename T, typename OP>
+        request ireduce(const communicator& comm, const T* val, int n, T* out_val, const OP& /*op*/, int root)
+        {
+            if (n<=0) {
+                throw std::invalid_argument("Non-positive array size in mpi::ireduce()");
+            }
+            if (val==out_val) {
+                throw std::invalid_argument("Implicit in-place mpi::ireduce() is not implemented");
+            }
+            request req;
+            MPI_Ireduce(const_cast<T*>(val), out_val, n, detail::mpi_type<T>(),
+                        is_mpi_op<OP,T>::op(), root, comm, req.mpi_request());
+            return req;
+        }
+
+        /// Starts MPI_Ireduce for a primitive type T; `out_val` is used on the root only
+        template <typename T, typename OP>
+        request ireduce(const communicator& comm, const T& val, T& out_val, const OP& op, int root)
+        {
+            return ireduce(comm, &val, 1, &out_val, op, root);
+        }
+
+        /// Starts MPI_Iallgather for primitive type T
+        /** @note Vector `out_vals` is resized immediately */
+        template <typename T>
+        request iall_gather(const communicator& comm, const T& in_val, std::vector<T>& out_vals) {
+            out_vals.resize(comm.size());
+            request req;
+            MPI_Iallgather(const_cast<T*>(&in_val), 1, detail::mpi_type<T>(),
+                           &out_vals.front(), 1, detail::mpi_type<T>(),
+                           comm, req.mpi_request());
+            return req;
+        }
+
+        /// Starts MPI_Igatherv of arrays of a primitive type T of different lengths to the root
+        /** @param in_vals array of `in_count` values contributed by this process
+            @param out_vals receives the arrays from all processes, one after another, in the order of ranks;
+                   resized immediately (on the root only)
+            @param counts numbers of values contributed by each process (significant on the root only)
+        */
+        template <typename T>
+        request igatherv(const communicator& comm, const T* in_vals, int in_count,
+                         std::vector<T>& out_vals, const std::vector<int>& counts, int root)
+        {
+            request req;
+            T* out_ptr=0;
+            const int* counts_ptr=0;
+            const int* displs_ptr=0;
+            if (comm.rank()==root) {
+                const int np=comm.size();
+                if (counts.size()!=std::size_t(np)) {
+                    throw std::invalid_argument("Size of counts must be the communicator size in mpi::igatherv()");
+                }
+                // counts and displacements must stay valid until the operation is completed
+                std::vector<int>& aux=req.aux();
+                aux.assign(counts.begin(), counts.end());
+                aux.resize(2*np);
+                std::size_t total=0;
+                for (int i=0; i<np; ++i) {
+                    aux[np+i]=total;
+                    total+=counts[i];
+                }
+                out_vals.resize(total);
+                if (total>0) out_ptr=&out_vals.front();
+                counts_ptr=&aux[0];
+                displs_ptr=&aux[np];
+            }
+            MPI_Igatherv(const_cast<T*>(in_vals), in_count, detail::mpi_type<T>(),
+                         out_ptr, counts_ptr, displs_ptr, detail::mpi_type<T>(),
+                         root, comm, req.mpi_request());
+            return req;
+        }
+
+    } // mpi::
+} // alps::
+
+
+#endif /* ALPS_UTILITIES_MPI_NONBLOCKING_HPP_INCLUDED_5c0d2a7e9b3f4e18a6d1c4b7f2e9a803 */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_profiling.hpp
+
+    @brief Header for combining profiling data of MPI processes
+*/
+
+#ifndef ALPS_UTILITIES_MPI_PROFILING_HPP_INCLUDED_c2a95e0f71d64b3e8f4b06d8a3e1c957
+#define ALPS_UTILITIES_MPI_PROFILING_HPP_INCLUDED_c2a95e0f71d64b3e8f4b06d8a3e1c957
+
+#include <alps/utilities/mpi.hpp>
+#include <alps/utilities/profiling.hpp>
+
+#include <vector>
+#include <string>
+
+namespace alps {
+    namespace profiling {
+
+        /// Merges the records of all processes of the communicator on the root (collective)
+        /** The statistics of the same timer or counter are combined over
+            the processes; the trace events keep the rank of their process.
+
+            @returns the combined report on the root, the report of this process elsewhere.
+        */
+        inline report collect(const alps::mpi::communicator& comm, int root) {
+            const int rank=comm.rank();
+            report rep=collect();
+            for (std::size_t i=0; i<rep.events.size(); ++i) rep.events[i].process=rank;
+
+            std::string buf;
+            detail::pack(rep, buf);
+            int size=buf.size();
+
+            const int np=comm.size();
+            std::vector<int> sizes(rank==root ? np : 0);
+            MPI_Gather(&size, 1, MPI_INT, (rank==root ? &sizes[0] : 0), 1, MPI_INT, root, comm);
+
+            std::vector<int> displs;
+            std::vector<char> all;
+            if (rank==root) {
+                displs.resize(np);
+                int total=0;
+                for (int i=0; i<np; ++i) {
+                    displs[i]=total;
+                    total+=sizes[i];
+                }
+                all.resize(total+1); // never empty
+            }
+            MPI_Gatherv(const_cast<char*>(buf.data()), size, MPI_CHAR,
+                        (rank==root ? &all[0] : 0), (rank==root ? &sizes[0] : 0), (rank==root ? &displs[0] : 0), MPI_CHAR,
+                        root, comm);
+            if (rank!=root) return rep;
+
+            report combined;
+            for (int i=0; i<np; ++i) {
+                combined.merge(detail::unpack(&all[displs[i]], sizes[i]));
+            }
+            return combined;
+        }
+
+    } // profiling::
+} // alps::
+
+#endif /* ALPS_UTILITIES_MPI_PROFILING_HPP_INCLUDED_c2a95e0f71d64b3e8f4b06d8a3e1c957 */
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_shared_array.hpp
+
+    @brief Header for read-only arrays kept once per node in (MPI-3) shared memory
+
+    @details
+    Large read-only data (tables, kernels, vertices...) broadcast to
+    every process is stored once per node rather than once per
+    process: the processes of a node map the same shared-memory
+    window, which is filled by one of them (the "node leader").
+*/
+
+#ifndef ALPS_UTILITIES_MPI_SHARED_ARRAY_HPP_INCLUDED_7e41b9c05d2a4f3c8b6e1d09a5f27c64
+#define ALPS_UTILITIES_MPI_SHARED_ARRAY_HPP_INCLUDED_7e41b9c05d2a4f3c8b6e1d09a5f27c64
+
+#include <alps/utilities/mpi.hpp>
+
+#if !defined(MPI_VERSION) || MPI_VERSION<3
+#error "Node-shared arrays require MPI-3"
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/shared_ptr.hpp>
+
+namespace alps {
+    namespace mpi {
+
+        namespace detail {
+            // Functor to free the shared-memory window (collectively!) when the last handle goes away
+            struct shared_window_deleter {
+                void operator()(MPI_Win* win_ptr) {
+                    int finalized;
+                    MPI_Finalized(&finalized);
+                    if (!finalized) {
+                        MPI_Win_unlock_all(*win_ptr);
+                        MPI_Win_free(win_ptr);
+                    }
+                    delete win_ptr;
+                }
+            };
+        } // detail::
+
+        /// Read-only array of `T` stored once per node, in memory shared by the processes of the node
+        /** The processes of the communicator are grouped by node
+            (`MPI_Comm_split_type()` with `MPI_COMM_TYPE_SHARED`), and the
+            array is allocated in the memory of the leader of each node.
+            All processes get a const view of it; the content is set by
+            the collective `fill()`, or by `broadcast_shared()`.
+
+            Copies of the object refer to the same array. Construction and
+            the destruction of the last copy are collective operations over
+            the communicator.
+
+            @tparam T a trivially copyable type
+        */
+        template <typename T>
+        class node_shared_array {
+            communicator node_comm_;
+            boost::shared_ptr<MPI_Win> win_ptr_;
+            T* data_;
+            std::size_t size_;
+
+            // Makes the leader's writes visible to the other processes of the node
+            void sync_() const {
+                MPI_Win_sync(*win_ptr_);
+                node_comm_.barrier();
+                MPI_Win_sync(*win_ptr_);
+            }
+
+          public:
+            typedef T value_type;
+            typedef const T* const_iterator;
+
+            /// Allocates array of `size` elements on each node of `comm` (collective over `comm`)
+            /** @param root the process that is the leader of its node; the
+                       leaders of other nodes are their lowest-rank processes.
+            */
+            node_shared_array(const communicator& comm, std::size_t size, int root=0)
+                : node_comm_(), win_ptr_(), data_(0), size_(size)
+            {
+                const int rank=comm.rank();
+                MPI_Comm node_comm;
+                MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, (rank==root ? 0 : rank+1), MPI_INFO_NULL, &node_comm);
+                node_comm_=communicator(node_comm, take_ownership);
+
+                const bool leader=is_node_leader();
+                void* base=0;
+                MPI_Win* win_ptr=new MPI_Win();
+                if (MPI_SUCCESS!=MPI_Win_allocate_shared(leader ? MPI_Aint(size*sizeof(T)) : 0, sizeof(T),
+                                                         MPI_INFO_NULL, node_comm_, &base, win_ptr)) {
+                    delete win_ptr;
+                    throw std::runtime_error("node_shared_array: cannot allocate shared memory window");
+                }
+                MPI_Win_lock_all(MPI_MODE_NOCHECK, *win_ptr);
+                win_ptr_.reset(win_ptr, detail::shared_window_deleter());
+                if (!leader) {
+                    MPI_Aint seg_size;
+                    int disp_unit;
+                    MPI_Win_shared_query(*win_ptr, 0, &seg_size, &disp_unit, &base);
+                }
+                data_=static_cast<T*>(base);
+            }
+
+            /// Number of elements
+            std::size_t size() const { return size_; }
+
+            /// True if the array has no elements
+            bool empty() const { return size_==0; }
+
+            /// Pointer to the data (on any process of the node)
+            const T* data() const { return data_; }
+
+            /// Access an element
+            const T& operator[](std::size_t i) const { return data_[i]; }
+
+            const_iterator begin() const { return data_; }
+            const_iterator end() const { return data_+size_; }
+
+            /// Communicator of the processes sharing this array on this node
+            const communicator& node_communicator() const { return node_comm_; }
+
+            /// True if this process is the one which fills the array on this node
+            bool is_node_leader() const { return node_comm_.rank()==0; }
+
+            /// Fills the array (collective over the node)
+            /** Waits until all processes of the node are done with the
+                previous content, calls `filler(T* data, std::size_t size)`
+                on the node leader only, and makes the result visible to all
+                processes of the node.
+             */
+            template <typename F>
+            void fill(F filler) {
+                node_comm_.barrier();
+                if (is_node_leader()) filler(data_, size_);
+                sync_();
+            }
+        };
+
+        namespace detail {
+            // Fills the array on the root, and broadcasts it to the other node leaders
+            template <typename T>
+            class shared_broadcaster {
+                const communicator& leaders_;
+                const T* vals_;
+              public:
+                /// `leaders` are the node leaders, the root first; `vals` is non-null on the root only
+                shared_broadcaster(const communicator& leaders, const T* vals)
+                    : leaders_(leaders), vals_(vals) {}
+
+                void operator()(T* data, std::size_t size) const {
+                    if (vals_ && size>0) std::copy(vals_, vals_+size, data);
+                    broadcast(leaders_, data, size, 0);
+                }
+            };
+        } // detail::
+
+        /// Broadcasts an array into node-shared memory (collective)
+        /** @param vals the data to broadcast, significant on the root only
+            @returns the node-shared copy of `vals`
+        */
+        template <typename T>
+        node_shared_array<T> broadcast_shared(const communicator& comm, const std::vector<T>& vals, int root)
+        {
+            const int rank=comm.rank();
+            std::size_t size=vals.size();
+            broadcast(comm, size, root);
+            node_shared_array<T> shared(comm, size, root);
+
+            // the data travel between nodes only, among the node leaders (the root is rank 0 of them)
+            MPI_Comm leaders_comm;
+            MPI_Comm_split(comm, (shared.is_node_leader() ? 0 : MPI_UNDEFINED), (rank==root ? 0 : rank+1), &leaders_comm);
+            const communicator leaders=(leaders_comm==MPI_COMM_NULL)
+                ? communicator(MPI_COMM_SELF, comm_attach) // not used
+                : communicator(leaders_comm, take_ownership);
+
+            shared.fill(detail::shared_broadcaster<T>(leaders, (rank==root && size>0) ? &vals[0] : 0));
+            return shared;
+        }
+
+    } // mpi::
+} // alps::
+
+
+#endif /* ALPS_UTILITIES_MPI_SHARED_ARRAY_HPP_INCLUDED_7e41b9c05d2a4f3c8b6e1d09a5f27c64 */
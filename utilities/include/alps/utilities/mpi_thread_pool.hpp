@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_thread_pool.hpp
+
+    @brief Header for sizing the shared thread pool in MPI runs
+
+    The tasks of the pool run on threads other than the one that called
+    `MPI_Init()`; they may use MPI only if the library provides
+    `MPI_THREAD_MULTIPLE` (see `alps::mpi::environment`), which
+    `tasks_may_call_mpi()` reports.
+*/
+
+#ifndef ALPS_UTILITIES_MPI_THREAD_POOL_HPP_INCLUDED_91d3c7e2b5a84f06a2e7c48b0d6f1e35
+#define ALPS_UTILITIES_MPI_THREAD_POOL_HPP_INCLUDED_91d3c7e2b5a84f06a2e7c48b0d6f1e35
+
+#include <alps/utilities/mpi.hpp>
+#include <alps/utilities/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace alps {
+    namespace threading {
+
+        /// Returns the number of processes of `comm` that share this node (collective)
+        inline int processes_on_node(const alps::mpi::communicator& comm) {
+            MPI_Comm node_comm;
+            MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, comm.rank(), MPI_INFO_NULL, &node_comm);
+            return alps::mpi::communicator(node_comm, alps::mpi::take_ownership).size();
+        }
+
+        /// Sizes the default pool so that the processes on a node do not oversubscribe it (collective)
+        /**
+            @param nthreads the number of threads per process; if 0, it is
+                   taken from the environment (`ALPS_NUM_THREADS` or
+                   `OMP_NUM_THREADS`), or else the hardware threads of the
+                   node are divided among its processes.
+            @returns the size of the default pool
+        */
+        inline std::size_t configure(const alps::mpi::communicator& comm, std::size_t nthreads=0) {
+            const int nlocal=processes_on_node(comm);
+            if (nthreads==0) nthreads=environment_threads();
+            if (nthreads==0) nthreads=std::max<std::size_t>(hardware_threads()/nlocal, 1);
+            set_num_threads(nthreads);
+            return num_threads();
+        }
+
+        /// Returns `true` if tasks run by the pool may make MPI calls
+        inline bool tasks_may_call_mpi() {
+            return alps::mpi::environment::thread_level()==MPI_THREAD_MULTIPLE;
+        }
+
+    } // threading::
+} // alps::
+
+#endif /* ALPS_UTILITIES_MPI_THREAD_POOL_HPP_INCLUDED_91d3c7e2b5a84f06a2e7c48b0d6f1e35 */
@@ -23,21 +23,48 @@ namespace alps {
     namespace mpi {
 
         /// MPI_BCast of a vector of strings
-        // FIXME!: make a test
+        /** The strings are sent as one block of characters, preceded by their lengths */
         // FIXME: what is exception safety status?
-        // FIXME: implement generically for non-contiguous types
-        // FIXME: inline to have it header-only. A tad too complex to be inlined?
         inline void broadcast(const communicator& comm, std::vector<std::string>& vec, int root)
         {
-            // FIXME? it might be better to trade traffic to memory and first combine elements in a vector
             using alps::mpi::broadcast;
+            const bool is_root=(comm.rank()==root);
             std::size_t root_sz=vec.size();
             broadcast(comm, root_sz, root);
-            if (comm.rank() != root) {
-                vec.resize(root_sz);
+            if (root_sz==0) {
+                vec.clear();
+                return;
             }
-            BOOST_FOREACH(std::string& elem, vec) {
-                broadcast(comm, elem, root);
+
+            std::vector<std::size_t> lengths(root_sz);
+            std::size_t total=0;
+            if (is_root) {
+                for (std::size_t i=0; i<root_sz; ++i) {
+                    lengths[i]=vec[i].size();
+                    total+=lengths[i];
+                }
+            }
+            broadcast(comm, &lengths[0], root_sz, root);
+
+            std::string chars;
+            if (is_root) {
+                chars.reserve(total);
+                BOOST_FOREACH(const std::string& elem, vec) {
+                    chars+=elem;
+                }
+            } else {
+                for (std::size_t i=0; i<root_sz; ++i) total+=lengths[i];
+                chars.resize(total);
+            }
+            if (total>0) broadcast(comm, &chars[0], total, root);
+
+            if (!is_root) {
+                vec.resize(root_sz);
+                std::size_t pos=0;
+                for (std::size_t i=0; i<root_sz; ++i) {
+                    vec[i].assign(chars, pos, lengths[i]);
+                    pos+=lengths[i];
+                }
             }
         }
 
@@ -58,27 +85,22 @@ namespace alps {
         }
       
         /// MPI_BCast of a vector of bool
-        // FIXME!: make a test
+        /** The (bit-packed) vector is sent as one block of `char` values */
         // FIXME: what is exception safety status?
-        // FIXME: implement generically for non-contiguous types
         inline void broadcast(const communicator& comm, std::vector<bool>& vec, int root)
         {
-            // FIXME? it might be better to trade traffic to memory and first combine elements in a vector
             using alps::mpi::broadcast;
-            typedef std::vector<bool> vector_type;
-            typedef vector_type::iterator iter_type;
-            
             std::size_t root_sz=vec.size();
             broadcast(comm, root_sz, root);
-            if (comm.rank() != root) {
-                vec.resize(root_sz);
+            if (root_sz==0) {
+                vec.clear();
+                return;
             }
 
-            for (iter_type it=vec.begin(); it!=vec.end(); ++it) {
-                bool elem=*it;
-                broadcast(comm, elem, root);
-                *it=elem;
-            }
+            std::vector<char> buf(vec.begin(), vec.end());
+            buf.resize(root_sz);
+            broadcast(comm, &buf[0], root_sz, root);
+            vec.assign(buf.begin(), buf.end());
         }
       
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file profiling.hpp
+
+    @brief Header for lightweight scoped timers and counters
+
+    @details
+    Timers and counters record into a buffer private to the calling
+    thread, so recording takes no locks. The buffers of all threads
+    are merged by `collect()` into a `report`, which can be printed,
+    written as Chrome trace-event JSON (`chrome://tracing`, Perfetto),
+    combined over MPI ranks (see mpi_profiling.hpp) or saved to HDF5
+    (see alps/hdf5/profiling.hpp).
+
+    Recording happens only after `enable()` is called, or if the
+    environment variable `ALPS_PROFILING` is set to a non-empty value
+    other than "0"; otherwise a timer costs one test of a flag.
+
+    The instrumentation of ALPSCore itself uses the macros
+    `ALPS_PROFILE_SCOPE()` and `ALPS_PROFILE_COUNT()`, which expand to
+    nothing unless ALPSCore is configured with `-DALPS_ENABLE_PROFILING=ON`.
+*/
+
+#ifndef ALPS_UTILITIES_PROFILING_HPP_INCLUDED_3f8e2c71d94b4a05b6a7e0c9d1f25e84
+#define ALPS_UTILITIES_PROFILING_HPP_INCLUDED_3f8e2c71d94b4a05b6a7e0c9d1f25e84
+
+#include <alps/config.hpp>
+
+#include <boost/cstdint.hpp>
+#include <boost/preprocessor/cat.hpp>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+namespace alps {
+    namespace profiling {
+
+        /// Accumulated statistics of the values recorded by a timer or a counter
+        struct statistics {
+            boost::uint64_t count; ///< number of recorded values
+            double total;          ///< sum of the values
+            double min;            ///< smallest value
+            double max;            ///< largest value
+
+            statistics();
+
+            /// Records a value
+            void add(double value);
+
+            /// Adds the values recorded by `rhs`
+            void merge(const statistics& rhs);
+
+            /// Mean value (0 if nothing recorded)
+            double mean() const { return count ? total/count : 0.; }
+        };
+
+        /// A timed interval, as shown in the trace
+        struct trace_event {
+            std::string name;
+            double begin;   ///< start, microseconds since the start of the process
+            double duration; ///< microseconds
+            int process;    ///< MPI rank (0 without MPI)
+            int thread;     ///< thread number, in order of first use
+
+            trace_event() : name(), begin(0), duration(0), process(0), thread(0) {}
+        };
+
+        /// Profiling data of a process (or of several processes, once combined)
+        class report {
+          public:
+            typedef std::map<std::string, statistics> statistics_map;
+
+            statistics_map timers;   ///< durations, seconds
+            statistics_map counters; ///< counted values
+            std::vector<trace_event> events; ///< intervals, if tracing is enabled
+
+            /// Adds the data of another report
+            void merge(const report& rhs);
+
+            /// True if nothing has been recorded
+            bool empty() const { return timers.empty() && counters.empty() && events.empty(); }
+
+            /// Prints a table of the statistics
+            void print(std::ostream& os) const;
+
+            /// Writes the trace events and the counter totals in the Chrome trace-event JSON format
+            void write_chrome_trace(std::ostream& os) const;
+        };
+
+        /// Starts recording; if `tracing` is true, the individual timed intervals are also kept
+        /** @param max_events the number of trace events kept per thread; further events are dropped */
+        void enable(bool tracing=false, std::size_t max_events=1000000);
+
+        /// Stops recording
+        void disable();
+
+        namespace detail {
+            /// Global flags: bit 0 set if recording, bit 1 set if tracing
+            extern std::atomic<int> state;
+
+            void record_time(const char* name, boost::uint64_t begin_ns, boost::uint64_t end_ns);
+            void record_count(const char* name, double value);
+            boost::uint64_t now_ns();
+
+            /// Appends a binary representation of the report to `buf` (e.g., to send it)
+            void pack(const report& rep, std::string& buf);
+
+            /// Restores a report from its binary representation
+            report unpack(const char* buf, std::size_t size);
+        }
+
+        /// True if recording
+        inline bool is_enabled() { return detail::state.load(std::memory_order_relaxed) & 1; }
+
+        /// True if keeping trace events
+        inline bool is_tracing() { return detail::state.load(std::memory_order_relaxed) & 2; }
+
+        /// Merges the records of all threads of this process
+        /** @note Threads must not record while their buffers are being collected. */
+        report collect();
+
+        /// Discards the records of all threads of this process
+        /** @note Threads must not record while their buffers are being reset. */
+        void reset();
+
+        /// Records the time spent between the construction and the destruction
+        /** @param name the timer name; must be a string that outlives the
+                   recording, e.g. a string literal. Timers are identified by
+                   the content of the name.
+        */
+        class scoped_timer {
+            const char* name_;
+            boost::uint64_t begin_;
+          public:
+            explicit scoped_timer(const char* name)
+                : name_(is_enabled() ? name : 0), begin_(name_ ? detail::now_ns() : 0) {}
+
+            ~scoped_timer() {
+                if (name_) detail::record_time(name_, begin_, detail::now_ns());
+            }
+
+          private:
+            scoped_timer(const scoped_timer&);
+            scoped_timer& operator=(const scoped_timer&);
+        };
+
+        /// Adds a value to the counter `name` (see `scoped_timer` for the naming requirements)
+        inline void count(const char* name, double value=1.) {
+            if (is_enabled()) detail::record_count(name, value);
+        }
+
+    } // profiling::
+} // alps::
+
+#ifdef ALPS_ENABLE_PROFILING
+/// Times the rest of the enclosing scope, under the name `name`
+#define ALPS_PROFILE_SCOPE(name) ::alps::profiling::scoped_timer BOOST_PP_CAT(alps_profile_scope_, __LINE__)(name)
+/// Adds `value` to the counter `name`
+#define ALPS_PROFILE_COUNT(name, value) ::alps::profiling::count(name, value)
+#else
+#define ALPS_PROFILE_SCOPE(name)
+#define ALPS_PROFILE_COUNT(name, value)
+#endif
+
+#endif /* ALPS_UTILITIES_PROFILING_HPP_INCLUDED_3f8e2c71d94b4a05b6a7e0c9d1f25e84 */
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file thread_pool.hpp
+
+    @brief Header for the shared work-stealing thread pool
+
+    All intra-node parallelism in ALPSCore is meant to go through one
+    pool, so that the features do not oversubscribe the cores:
+
+        alps::threading::parallel_for(0, n, [&](std::size_t i) { out[i]=f(in[i]); });
+
+        alps::threading::task_group tasks;
+        tasks.run([&]() { ar1 >> x; });
+        tasks.run([&]() { ar2 >> y; });
+        tasks.wait(); // rethrows the first exception of a task
+
+    The size of the default pool is taken from the environment variable
+    `ALPS_NUM_THREADS` (falling back to `OMP_NUM_THREADS` and then to the
+    number of hardware threads), or set explicitly with `set_num_threads()`.
+    See also `alps/params/thread_pool_params.hpp` and, for MPI runs,
+    `alps/utilities/mpi_thread_pool.hpp`.
+*/
+
+#ifndef ALPS_UTILITIES_THREAD_POOL_HPP_INCLUDED_4e1f0b7a9c2d43a6b85e3d61f07c29a4
+#define ALPS_UTILITIES_THREAD_POOL_HPP_INCLUDED_4e1f0b7a9c2d43a6b85e3d61f07c29a4
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace alps {
+    namespace threading {
+
+        /// Pool of worker threads executing tasks, with a work-stealing queue per worker
+        /**
+            A pool of size `n` runs `n-1` worker threads: the thread waiting
+            for a `task_group` executes pending tasks as well and is the
+            `n`-th one. A pool of size 1 runs everything in the waiting thread.
+
+            Tasks submitted from a worker go to its own queue (and are taken
+            last-in-first-out by that worker); the idle workers steal the
+            oldest tasks from the other queues.
+        */
+        class thread_pool {
+          public:
+            typedef std::function<void()> task_type;
+
+            /// Starts `nthreads-1` worker threads (`nthreads==0` is treated as 1)
+            explicit thread_pool(std::size_t nthreads);
+
+            /// Finishes the pending tasks and joins the workers
+            ~thread_pool();
+
+            /// Number of threads executing the tasks, including the waiting thread
+            std::size_t size() const { return workers_.size()+1; }
+
+            /// Enqueues a task; prefer `task_group::run()`, which tracks completion and exceptions
+            void submit(task_type task);
+
+            /// Runs one pending task in the calling thread, if there is one
+            /** @returns `true` if a task has been run */
+            bool run_pending_task();
+
+          private:
+            struct task_queue {
+                std::mutex mutex;
+                std::deque<task_type> tasks;
+            };
+
+            thread_pool(const thread_pool&);
+            thread_pool& operator=(const thread_pool&);
+
+            bool pop_task(std::size_t home, task_type& task);
+            void worker_loop(std::size_t index);
+
+            // one queue per worker, the last one receives the tasks submitted from outside
+            std::vector<std::unique_ptr<task_queue> > queues_;
+            std::vector<std::thread> workers_;
+            std::atomic<std::size_t> pending_;
+            std::mutex wake_mutex_;
+            std::condition_variable wake_;
+            bool stop_;
+        };
+
+        /// Returns the number of hardware threads (at least 1)
+        std::size_t hardware_threads();
+
+        /// Returns the number of threads requested by `ALPS_NUM_THREADS` or `OMP_NUM_THREADS`, or 0
+        std::size_t environment_threads();
+
+        /// Returns the pool shared by all of ALPSCore, creating it if needed
+        thread_pool& default_pool();
+
+        /// Recreates the default pool with the given number of threads
+        /**
+            With `nthreads==0` the size is taken from the environment, or
+            else it is the number of hardware threads.
+
+            @note Must not be called while tasks are running in the default pool.
+        */
+        void set_num_threads(std::size_t nthreads);
+
+        /// Returns the number of threads of the default pool
+        inline std::size_t num_threads() { return default_pool().size(); }
+
+
+        /// A set of tasks to be waited for together
+        /**
+            Tasks may be run from within other tasks; a task waiting for its
+            own group executes pending tasks meanwhile, so nesting does not
+            deadlock the pool.
+        */
+        class task_group {
+          public:
+            explicit task_group(thread_pool& pool=default_pool())
+                : pool_(pool), pending_(0)
+            { }
+
+            /// Waits for the remaining tasks, discarding their exceptions
+            ~task_group();
+
+            /// Submits `fn()` for execution
+            template <typename F>
+            void run(F fn) {
+                pending_.fetch_add(1);
+                pool_.submit(runner<F>(this, fn));
+            }
+
+            /// Waits for all tasks of the group, helping to execute them
+            /** @throws the first exception escaped from a task */
+            void wait();
+
+          private:
+            template <typename F>
+            struct runner {
+                task_group* group;
+                F fn;
+                runner(task_group* g, const F& f) : group(g), fn(f) { }
+                void operator()() {
+                    try {
+                        fn();
+                    } catch (...) {
+                        group->set_error(std::current_exception());
+                    }
+                    group->finish();
+                }
+            };
+
+            task_group(const task_group&);
+            task_group& operator=(const task_group&);
+
+            void set_error(std::exception_ptr error);
+            void finish();
+            void wait_for_tasks();
+
+            thread_pool& pool_;
+            std::atomic<std::size_t> pending_;
+            std::mutex mutex_;
+            std::condition_variable done_;
+            std::exception_ptr error_;
+        };
+
+
+        /// Calls `fn(i)` for every `i` in `[first,last)` in parallel
+        /**
+            The range is split into contiguous chunks of at least `grain`
+            indices (by default, about 4 chunks per thread of the pool).
+            The calling thread executes chunks as well.
+
+            @throws the first exception escaped from `fn`
+        */
+        template <typename I, typename F>
+        void parallel_for(I first, I last, F fn, std::size_t grain=0, thread_pool& pool=default_pool())
+        {
+            if (!(first<last)) return;
+            const std::size_t n=last-first;
+            const std::size_t nthreads=pool.size();
+            if (grain==0) grain=(n+4*nthreads-1)/(4*nthreads);
+            if (nthreads==1 || n<=grain) {
+                for (I i=first; i!=last; ++i) fn(i);
+                return;
+            }
+
+            task_group tasks(pool);
+            for (std::size_t begin=grain; begin<n; begin+=grain) {
+                const I chunk_first=first+begin;
+                const I chunk_last=(n-begin>grain) ? chunk_first+grain : last;
+                tasks.run([chunk_first, chunk_last, &fn]() {
+                        for (I i=chunk_first; i!=chunk_last; ++i) fn(i);
+                    });
+            }
+            // if this throws, the destructor of `tasks` waits for the other chunks
+            const I head_last=first+grain;
+            for (I i=first; i!=head_last; ++i) fn(i);
+            tasks.wait();
+        }
+
+    } // threading::
+} // alps::
+
+#endif /* ALPS_UTILITIES_THREAD_POOL_HPP_INCLUDED_4e1f0b7a9c2d43a6b85e3d61f07c29a4 */
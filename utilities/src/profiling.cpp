@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/profiling.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace alps {
+    namespace profiling {
+
+        namespace {
+            typedef std::chrono::steady_clock clock_type;
+
+            // The moment the trace times are counted from
+            const clock_type::time_point epoch=clock_type::now();
+
+            // Initial state: recording if requested by the environment
+            int initial_state() {
+                const char* env=std::getenv("ALPS_PROFILING");
+                return (env && *env && std::strcmp(env, "0")!=0) ? 1 : 0;
+            }
+
+            // A timed interval, as recorded
+            struct raw_event {
+                const char* name;
+                boost::uint64_t begin;
+                boost::uint64_t end;
+            };
+
+            // The records of one thread; only the owning thread writes to it
+            struct thread_buffer {
+                typedef std::unordered_map<const char*, statistics> map_type;
+                map_type timers;
+                map_type counters;
+                std::vector<raw_event> events;
+                int thread;
+
+                explicit thread_buffer(int thr) : timers(), counters(), events(), thread(thr) {}
+
+                void clear() {
+                    timers.clear();
+                    counters.clear();
+                    events.clear();
+                }
+            };
+
+            // All thread buffers ever created; they outlive their threads
+            struct registry {
+                std::mutex mutex;
+                std::vector< boost::shared_ptr<thread_buffer> > buffers;
+                std::size_t max_events;
+
+                registry() : mutex(), buffers(), max_events(0) {}
+            };
+
+            registry& get_registry() {
+                static registry reg;
+                return reg;
+            }
+
+            thread_local thread_buffer* this_thread_buffer=0;
+
+            thread_buffer& get_thread_buffer() {
+                if (!this_thread_buffer) {
+                    registry& reg=get_registry();
+                    std::lock_guard<std::mutex> lock(reg.mutex);
+                    boost::shared_ptr<thread_buffer> buf(new thread_buffer(reg.buffers.size()));
+                    reg.buffers.push_back(buf);
+                    this_thread_buffer=buf.get();
+                }
+                return *this_thread_buffer;
+            }
+
+            void merge_into(report::statistics_map& out, const thread_buffer::map_type& in) {
+                for (thread_buffer::map_type::const_iterator it=in.begin(); it!=in.end(); ++it) {
+                    out[it->first].merge(it->second);
+                }
+            }
+
+            // Writes a JSON string literal
+            void write_json_string(std::ostream& os, const std::string& str) {
+                os << '"';
+                for (std::size_t i=0; i<str.size(); ++i) {
+                    const char c=str[i];
+                    switch (c) {
+                      case '"': os << "\\\""; break;
+                      case '\\': os << "\\\\"; break;
+                      case '\n': os << "\\n"; break;
+                      case '\t': os << "\\t"; break;
+                      default:
+                        if (static_cast<unsigned char>(c)<0x20) {
+                            char hex[8];
+                            std::sprintf(hex, "\\u%04x", static_cast<unsigned int>(c));
+                            os << hex;
+                        } else {
+                            os << c;
+                        }
+                    }
+                }
+                os << '"';
+            }
+
+            template <typename T>
+            void pack_value(std::string& buf, const T& val) {
+                buf.append(reinterpret_cast<const char*>(&val), sizeof(T));
+            }
+
+            void pack_string(std::string& buf, const std::string& str) {
+                pack_value(buf, boost::uint64_t(str.size()));
+                buf.append(str);
+            }
+
+            void pack_map(std::string& buf, const report::statistics_map& stats) {
+                pack_value(buf, boost::uint64_t(stats.size()));
+                for (report::statistics_map::const_iterator it=stats.begin(); it!=stats.end(); ++it) {
+                    pack_string(buf, it->first);
+                    pack_value(buf, it->second);
+                }
+            }
+
+            // Reads the packed data in order
+            class unpacker {
+                const char* pos_;
+                const char* end_;
+
+                void check(std::size_t len) const {
+                    if (std::size_t(end_-pos_)<len) {
+                        throw std::invalid_argument("Truncated profiling data");
+                    }
+                }
+              public:
+                unpacker(const char* buf, std::size_t size) : pos_(buf), end_(buf+size) {}
+
+                template <typename T>
+                T value() {
+                    check(sizeof(T));
+                    T val;
+                    std::memcpy(&val, pos_, sizeof(T));
+                    pos_+=sizeof(T);
+                    return val;
+                }
+
+                std::string string() {
+                    const std::size_t len=value<boost::uint64_t>();
+                    check(len);
+                    std::string str(pos_, len);
+                    pos_+=len;
+                    return str;
+                }
+
+                void map(report::statistics_map& stats) {
+                    const std::size_t n=value<boost::uint64_t>();
+                    for (std::size_t i=0; i<n; ++i) {
+                        const std::string name=string();
+                        stats[name].merge(value<statistics>());
+                    }
+                }
+            };
+        }
+
+        statistics::statistics()
+            : count(0), total(0.),
+              min(std::numeric_limits<double>::infinity()),
+              max(-std::numeric_limits<double>::infinity())
+        {}
+
+        void statistics::add(double value) {
+            ++count;
+            total+=value;
+            if (value<min) min=value;
+            if (value>max) max=value;
+        }
+
+        void statistics::merge(const statistics& rhs) {
+            count+=rhs.count;
+            total+=rhs.total;
+            min=std::min(min, rhs.min);
+            max=std::max(max, rhs.max);
+        }
+
+        void report::merge(const report& rhs) {
+            for (statistics_map::const_iterator it=rhs.timers.begin(); it!=rhs.timers.end(); ++it) {
+                timers[it->first].merge(it->second);
+            }
+            for (statistics_map::const_iterator it=rhs.counters.begin(); it!=rhs.counters.end(); ++it) {
+                counters[it->first].merge(it->second);
+            }
+            events.insert(events.end(), rhs.events.begin(), rhs.events.end());
+        }
+
+        void report::print(std::ostream& os) const {
+            const std::ios::fmtflags flags=os.flags();
+            os << std::left << std::setw(32) << "timer" << std::right
+               << std::setw(12) << "count" << std::setw(14) << "total [s]"
+               << std::setw(14) << "mean [s]" << std::setw(14) << "min [s]" << std::setw(14) << "max [s]" << "\n";
+            for (statistics_map::const_iterator it=timers.begin(); it!=timers.end(); ++it) {
+                const statistics& st=it->second;
+                os << std::left << std::setw(32) << it->first << std::right
+                   << std::setw(12) << st.count << std::setw(14) << st.total
+                   << std::setw(14) << st.mean() << std::setw(14) << st.min << std::setw(14) << st.max << "\n";
+            }
+            if (!counters.empty()) {
+                os << std::left << std::setw(32) << "counter" << std::right
+                   << std::setw(12) << "count" << std::setw(14) << "total" << "\n";
+                for (statistics_map::const_iterator it=counters.begin(); it!=counters.end(); ++it) {
+                    os << std::left << std::setw(32) << it->first << std::right
+                       << std::setw(12) << it->second.count << std::setw(14) << it->second.total << "\n";
+                }
+            }
+            os.flags(flags);
+        }
+
+        void report::write_chrome_trace(std::ostream& os) const {
+            const std::streamsize precision=os.precision(15);
+            os << "{\"traceEvents\":[";
+            double end=0;
+            bool first=true;
+            for (std::size_t i=0; i<events.size(); ++i) {
+                const trace_event& ev=events[i];
+                os << (first ? "\n" : ",\n") << "{\"name\":";
+                write_json_string(os, ev.name);
+                os << ",\"ph\":\"X\",\"ts\":" << ev.begin << ",\"dur\":" << ev.duration
+                   << ",\"pid\":" << ev.process << ",\"tid\":" << ev.thread << "}";
+                end=std::max(end, ev.begin+ev.duration);
+                first=false;
+            }
+            // counters are shown with their totals, at the end of the trace
+            for (statistics_map::const_iterator it=counters.begin(); it!=counters.end(); ++it) {
+                os << (first ? "\n" : ",\n") << "{\"name\":";
+                write_json_string(os, it->first);
+                os << ",\"ph\":\"C\",\"ts\":" << end << ",\"pid\":0,\"args\":{\"total\":" << it->second.total << "}}";
+                first=false;
+            }
+            os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+            os.precision(precision);
+        }
+
+        namespace detail {
+            std::atomic<int> state(initial_state());
+
+            boost::uint64_t now_ns() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now()-epoch).count();
+            }
+
+            void record_time(const char* name, boost::uint64_t begin_ns, boost::uint64_t end_ns) {
+                thread_buffer& buf=get_thread_buffer();
+                buf.timers[name].add(1E-9*(end_ns-begin_ns));
+                if (is_tracing() && buf.events.size()<get_registry().max_events) {
+                    raw_event ev={ name, begin_ns, end_ns };
+                    buf.events.push_back(ev);
+                }
+            }
+
+            void record_count(const char* name, double value) {
+                get_thread_buffer().counters[name].add(value);
+            }
+
+            void pack(const report& rep, std::string& buf) {
+                pack_map(buf, rep.timers);
+                pack_map(buf, rep.counters);
+                pack_value(buf, boost::uint64_t(rep.events.size()));
+                for (std::size_t i=0; i<rep.events.size(); ++i) {
+                    const trace_event& ev=rep.events[i];
+                    pack_string(buf, ev.name);
+                    pack_value(buf, ev.begin);
+                    pack_value(buf, ev.duration);
+                    pack_value(buf, ev.process);
+                    pack_value(buf, ev.thread);
+                }
+            }
+
+            report unpack(const char* buf, std::size_t size) {
+                unpacker in(buf, size);
+                report rep;
+                in.map(rep.timers);
+                in.map(rep.counters);
+                const std::size_t nevents=in.value<boost::uint64_t>();
+                rep.events.resize(nevents);
+                for (std::size_t i=0; i<nevents; ++i) {
+                    trace_event& ev=rep.events[i];
+                    ev.name=in.string();
+                    ev.begin=in.value<double>();
+                    ev.duration=in.value<double>();
+                    ev.process=in.value<int>();
+                    ev.thread=in.value<int>();
+                }
+                return rep;
+            }
+        }
+
+        void enable(bool tracing, std::size_t max_events) {
+            {
+                registry& reg=get_registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                reg.max_events=tracing ? max_events : 0;
+            }
+            detail::state=(tracing ? 3 : 1);
+        }
+
+        void disable() {
+            detail::state=0;
+        }
+
+        report collect() {
+            registry& reg=get_registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            report rep;
+            for (std::size_t i=0; i<reg.buffers.size(); ++i) {
+                const thread_buffer& buf=*reg.buffers[i];
+                merge_into(rep.timers, buf.timers);
+                merge_into(rep.counters, buf.counters);
+                for (std::size_t j=0; j<buf.events.size(); ++j) {
+                    const raw_event& raw=buf.events[j];
+                    trace_event ev;
+                    ev.name=raw.name;
+                    ev.begin=1E-3*raw.begin;
+                    ev.duration=1E-3*(raw.end-raw.begin);
+                    ev.thread=buf.thread;
+                    rep.events.push_back(ev);
+                }
+            }
+            return rep;
+        }
+
+        void reset() {
+            registry& reg=get_registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (std::size_t i=0; i<reg.buffers.size(); ++i) reg.buffers[i]->clear();
+        }
+
+    } // profiling::
+} // alps::
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file thread_pool.cpp
+
+    @brief Implements the shared work-stealing thread pool
+*/
+
+#include <alps/utilities/thread_pool.hpp>
+
+#include <chrono>
+#include <cstdlib>
+
+namespace alps {
+    namespace threading {
+
+        namespace {
+            // The pool and the queue index of the current thread, if it is a worker
+            thread_local thread_pool* current_pool=nullptr;
+            thread_local std::size_t current_queue=0;
+
+            std::size_t parse_threads(const char* value) {
+                if (!value) return 0;
+                char* end=nullptr;
+                const long n=std::strtol(value, &end, 10);
+                return (end!=value && n>0) ? n : 0;
+            }
+
+            std::mutex default_pool_mutex;
+            std::unique_ptr<thread_pool> default_pool_ptr;
+        }
+
+        thread_pool::thread_pool(std::size_t nthreads)
+            : pending_(0), stop_(false)
+        {
+            const std::size_t nworkers=(nthreads>1) ? nthreads-1 : 0;
+            for (std::size_t i=0; i<=nworkers; ++i) {
+                queues_.push_back(std::unique_ptr<task_queue>(new task_queue));
+            }
+            workers_.reserve(nworkers);
+            for (std::size_t i=0; i<nworkers; ++i) {
+                workers_.push_back(std::thread(&thread_pool::worker_loop, this, i));
+            }
+        }
+
+        thread_pool::~thread_pool()
+        {
+            // tasks submitted to a pool without workers are run here
+            while (run_pending_task()) { }
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stop_=true;
+            }
+            wake_.notify_all();
+            for (std::size_t i=0; i<workers_.size(); ++i) workers_[i].join();
+        }
+
+        void thread_pool::submit(task_type task)
+        {
+            const std::size_t index=(current_pool==this) ? current_queue : queues_.size()-1;
+            {
+                std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+                queues_[index]->tasks.push_back(std::move(task));
+            }
+            pending_.fetch_add(1);
+            // taking the lock orders the increment before a worker's check of the wait predicate
+            { std::lock_guard<std::mutex> lock(wake_mutex_); }
+            wake_.notify_one();
+        }
+
+        bool thread_pool::pop_task(std::size_t home, task_type& task)
+        {
+            if (pending_.load()==0) return false;
+            const std::size_t nqueues=queues_.size();
+            {
+                task_queue& own=*queues_[home];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task=std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    pending_.fetch_sub(1);
+                    return true;
+                }
+            }
+            for (std::size_t k=1; k<nqueues; ++k) {
+                task_queue& other=*queues_[(home+k)%nqueues];
+                std::lock_guard<std::mutex> lock(other.mutex);
+                if (!other.tasks.empty()) {
+                    task=std::move(other.tasks.front());
+                    other.tasks.pop_front();
+                    pending_.fetch_sub(1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool thread_pool::run_pending_task()
+        {
+            const std::size_t home=(current_pool==this) ? current_queue : queues_.size()-1;
+            task_type task;
+            if (!pop_task(home, task)) return false;
+            task();
+            return true;
+        }
+
+        void thread_pool::worker_loop(std::size_t index)
+        {
+            current_pool=this;
+            current_queue=index;
+            task_type task;
+            while (true) {
+                if (pop_task(index, task)) {
+                    task();
+                    task=task_type();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait(lock, [this]() { return stop_ || pending_.load()>0; });
+                if (stop_ && pending_.load()==0) return;
+            }
+        }
+
+
+        std::size_t hardware_threads()
+        {
+            const std::size_t n=std::thread::hardware_concurrency();
+            return n>0 ? n : 1;
+        }
+
+        std::size_t environment_threads()
+        {
+            const std::size_t n=parse_threads(std::getenv("ALPS_NUM_THREADS"));
+            return n>0 ? n : parse_threads(std::getenv("OMP_NUM_THREADS"));
+        }
+
+        thread_pool& default_pool()
+        {
+            std::lock_guard<std::mutex> lock(default_pool_mutex);
+            if (!default_pool_ptr) {
+                const std::size_t n=environment_threads();
+                default_pool_ptr.reset(new thread_pool(n>0 ? n : hardware_threads()));
+            }
+            return *default_pool_ptr;
+        }
+
+        void set_num_threads(std::size_t nthreads)
+        {
+            if (nthreads==0) nthreads=environment_threads();
+            if (nthreads==0) nthreads=hardware_threads();
+            std::lock_guard<std::mutex> lock(default_pool_mutex);
+            if (default_pool_ptr && default_pool_ptr->size()==nthreads) return;
+            default_pool_ptr.reset(); // joins the old workers first
+            default_pool_ptr.reset(new thread_pool(nthreads));
+        }
+
+
+        task_group::~task_group()
+        {
+            wait_for_tasks();
+        }
+
+        void task_group::wait()
+        {
+            wait_for_tasks();
+            std::exception_ptr error;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::swap(error, error_);
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+        void task_group::set_error(std::exception_ptr error)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_=error;
+        }
+
+        void task_group::finish()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.fetch_sub(1)==1) done_.notify_all();
+        }
+
+        void task_group::wait_for_tasks()
+        {
+            while (pending_.load()>0) {
+                if (pool_.run_pending_task()) continue;
+                // our tasks are running elsewhere: sleep, but look for new work now and then
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return pending_.load()==0; });
+            }
+            // the last finish() may still hold the mutex: the group must outlive it
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+
+    } // threading::
+} // alps::
@@ -8,6 +8,7 @@
 #include <boost/scoped_array.hpp>
 
 #include <alps/utilities/mpi.hpp>
+#include <alps/utilities/mpi_vector.hpp>
 
 #include <gtest/gtest.h>
 
@@ -92,6 +93,22 @@ class MpiBcastTest_base : public ::testing::Test {
         }
     }        
 
+    void bcast_vector() {
+        // root and slaves start with vectors of different sizes
+        vector_type root_data=alps::testing::datapoint<vector_type>::get(true,37);
+        vector_type slave_data=alps::testing::datapoint<vector_type>::get(false,5);
+        vector_type& my_data=*(this->is_root_? &root_data : &slave_data);
+
+        am::broadcast(comm_, my_data, ROOT_);
+
+        ASSERT_EQ(root_data.size(), my_data.size());
+        EXPECT_TRUE(std::equal(root_data.begin(), root_data.end(), my_data.begin()));
+
+        vector_type empty;
+        vector_type& my_empty=*(this->is_root_? &empty : &slave_data);
+        am::broadcast(comm_, my_empty, ROOT_);
+        EXPECT_TRUE(my_empty.empty());
+    }
 };
 
 template <typename T>
@@ -134,6 +151,7 @@ TYPED_TEST_CASE(MpiBcastTest, MyTestTypes);
 
 TYPED_TEST(MpiBcastTest, BcastScalar) { this->bcast_scalar(); }
 TYPED_TEST(MpiBcastTest, BcastArray) { this->bcast_array(); }
+TYPED_TEST(MpiBcastTest, BcastVector) { this->bcast_vector(); }
 
 
 int main(int argc, char** argv)
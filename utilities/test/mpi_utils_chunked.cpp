@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+// Tiny chunks, so that moderate arrays are transferred by many MPI calls
+#define ALPS_MPI_CHUNK_BYTES 64
+
+#include <alps/utilities/mpi.hpp>
+#include <alps/utilities/boost_mpi.hpp>
+
+#include <gtest/gtest.h>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+/* Test MPI array operations transferred in chunks */
+
+namespace am=alps::mpi;
+
+class MpiChunkedTest : public ::testing::Test {
+  protected:
+    static const int ROOT_=0;
+    am::communicator comm_;
+    int rank_;
+    int nproc_;
+    bool is_root_;
+
+  public:
+    MpiChunkedTest() : comm_(),
+                       rank_(comm_.rank()),
+                       nproc_(comm_.size()),
+                       is_root_(ROOT_==rank_)
+    {}
+
+    // make the number a bit more interesting than 0...nproc
+    static long mangle(int i, int j) {
+        return 7*i+23+1000*j;
+    }
+};
+
+TEST_F(MpiChunkedTest, ChunkLength) {
+    EXPECT_EQ(8u, am::detail::chunk_length(sizeof(double)));
+    EXPECT_EQ(64u, am::detail::chunk_length(1));
+    EXPECT_EQ(1u, am::detail::chunk_length(100));
+}
+
+TEST_F(MpiChunkedTest, Broadcast) {
+    const std::size_t n=1001; // not a multiple of any chunk length
+    std::vector<double> expected(n), data(n);
+    std::vector< std::complex<double> > cexpected(n), cdata(n);
+    std::vector<char> chars(n);
+    bool flags[n];
+    for (std::size_t i=0; i<n; ++i) {
+        expected[i]=alps::testing::datapoint<double>::get(int(i));
+        cexpected[i]=std::complex<double>(i, -2.*i);
+        flags[i]=is_root_ ? (i%3==0) : !(i%3==0);
+        if (is_root_) {
+            data[i]=expected[i];
+            cdata[i]=cexpected[i];
+            chars[i]='A'+i%26;
+        }
+    }
+
+    am::broadcast(comm_, &data[0], n, ROOT_);
+    am::broadcast(comm_, &cdata[0], n, ROOT_);
+    am::broadcast(comm_, &chars[0], n, ROOT_);
+    am::broadcast(comm_, flags, n, ROOT_);
+
+    EXPECT_EQ(expected, data);
+    EXPECT_EQ(cexpected, cdata);
+    for (std::size_t i=0; i<n; ++i) {
+        ASSERT_EQ(char('A'+i%26), chars[i]);
+        ASSERT_EQ(i%3==0, flags[i]);
+    }
+}
+
+TEST_F(MpiChunkedTest, Reduce) {
+    const int n=101;
+    std::vector<long> in(n), out(n, -1), root_out(n, -1), expected(n, 0);
+    for (int j=0; j<n; ++j) {
+        in[j]=mangle(rank_, j);
+        for (int i=0; i<nproc_; ++i) expected[j]+=mangle(i, j);
+    }
+
+    am::all_reduce(comm_, &in[0], n, &out[0], std::plus<long>());
+    EXPECT_EQ(expected, out);
+
+    if (is_root_) {
+        am::reduce(comm_, &in[0], n, &root_out[0], std::plus<long>(), ROOT_);
+        EXPECT_EQ(expected, root_out);
+        EXPECT_THROW(am::reduce(comm_, &in[0], n, std::plus<long>(), ROOT_), std::logic_error);
+    } else {
+        am::reduce(comm_, &in[0], n, std::plus<long>(), ROOT_);
+    }
+
+    std::vector<long> vec_out;
+    am::reduce(comm_, in, vec_out, am::maximum<long>(), ROOT_);
+    ASSERT_EQ(in.size(), vec_out.size());
+    if (is_root_) EXPECT_EQ(mangle(nproc_-1, n-1), vec_out[n-1]);
+
+    EXPECT_THROW(am::reduce(comm_, &in[0], 0, &out[0], std::plus<long>(), ROOT_), std::invalid_argument);
+}
+
+TEST_F(MpiChunkedTest, Gather) {
+    const int sizes[]={1, 37};
+    for (int k=0; k<2; ++k) {
+        const int n=sizes[k];
+        std::vector<long> in(n);
+        for (int j=0; j<n; ++j) in[j]=mangle(rank_, j);
+        std::vector<long> out(is_root_ ? n*nproc_ : 0, -1);
+
+        am::gather(comm_, &in[0], n, is_root_ ? &out[0] : 0, ROOT_);
+
+        if (is_root_) {
+            for (int i=0; i<nproc_; ++i) {
+                for (int j=0; j<n; ++j) {
+                    ASSERT_EQ(mangle(i, j), out[i*n+j]) << "rank=" << i << " j=" << j;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
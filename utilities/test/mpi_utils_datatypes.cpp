@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mpi.hpp>
+
+#include <gtest/gtest.h>
+
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+/* Test MPI datatypes of fixed-width, complex and user-defined types */
+
+namespace am=alps::mpi;
+
+namespace {
+    // A user-defined trivially copyable type
+    struct point {
+        double x;
+        int n;
+        char tag[3];
+    };
+
+    point make_point(int i) {
+        point p;
+        p.x=0.5*i;
+        p.n=7*i+23;
+        p.tag[0]='a'+(i%26); p.tag[1]='z'; p.tag[2]=0;
+        return p;
+    }
+
+    void expect_eq(const point& expected, const point& actual) {
+        EXPECT_EQ(expected.x, actual.x);
+        EXPECT_EQ(expected.n, actual.n);
+        EXPECT_EQ(std::string(expected.tag), std::string(actual.tag));
+    }
+
+    // Commutative reduction of points
+    struct point_plus {
+        point operator()(const point& a, const point& b) const {
+            point p=a;
+            p.x+=b.x;
+            p.n+=b.n;
+            p.tag[0]=std::min(a.tag[0], b.tag[0]);
+            return p;
+        }
+    };
+
+    template <typename T>
+    int mpi_size_of() {
+        int sz;
+        MPI_Type_size(am::detail::mpi_type<T>(), &sz);
+        return sz;
+    }
+}
+
+class MpiDatatypesTest : public ::testing::Test {
+  protected:
+    static const int ROOT_=0;
+    am::communicator comm_;
+    int rank_;
+    int nproc_;
+    bool is_root_;
+
+  public:
+    MpiDatatypesTest() : comm_(),
+                         rank_(comm_.rank()),
+                         nproc_(comm_.size()),
+                         is_root_(ROOT_==rank_)
+    {}
+};
+
+TEST_F(MpiDatatypesTest, FixedWidth) {
+    EXPECT_EQ(1, mpi_size_of<boost::int8_t>());
+    EXPECT_EQ(2, mpi_size_of<boost::int16_t>());
+    EXPECT_EQ(4, mpi_size_of<boost::int32_t>());
+    EXPECT_EQ(8, mpi_size_of<boost::int64_t>());
+    EXPECT_EQ(1, mpi_size_of<boost::uint8_t>());
+    EXPECT_EQ(2, mpi_size_of<boost::uint16_t>());
+    EXPECT_EQ(4, mpi_size_of<boost::uint32_t>());
+    EXPECT_EQ(8, mpi_size_of<boost::uint64_t>());
+
+    const boost::int64_t big=am::all_reduce(comm_, boost::int64_t(1)<<40, std::plus<boost::int64_t>());
+    EXPECT_EQ(nproc_*(boost::int64_t(1)<<40), big);
+}
+
+TEST_F(MpiDatatypesTest, Complex) {
+    EXPECT_EQ(int(sizeof(std::complex<float>)), mpi_size_of< std::complex<float> >());
+    EXPECT_EQ(int(sizeof(std::complex<double>)), mpi_size_of< std::complex<double> >());
+
+    typedef std::complex<double> cplx;
+    const int n=3;
+    cplx in[n], out[n];
+    for (int j=0; j<n; ++j) in[j]=cplx(rank_, -(j+1.)*rank_);
+    am::all_reduce(comm_, in, n, out, std::plus<cplx>());
+
+    const double rank_sum=0.5*nproc_*(nproc_-1);
+    for (int j=0; j<n; ++j) {
+        EXPECT_EQ(cplx(rank_sum, -(j+1.)*rank_sum), out[j]);
+    }
+}
+
+TEST_F(MpiDatatypesTest, StructBroadcast) {
+    EXPECT_EQ(int(sizeof(point)), mpi_size_of<point>());
+
+    const std::size_t n=10;
+    std::vector<point> pts(n);
+    for (std::size_t i=0; i<n; ++i) pts[i]=is_root_ ? make_point(i) : make_point(-1);
+    am::broadcast(comm_, &pts[0], n, ROOT_);
+    for (std::size_t i=0; i<n; ++i) {
+        expect_eq(make_point(i), pts[i]);
+    }
+}
+
+TEST_F(MpiDatatypesTest, StructReduce) {
+    const point mine=make_point(rank_);
+    const point sum=am::all_reduce(comm_, mine, point_plus());
+
+    point expected=make_point(0);
+    for (int i=1; i<nproc_; ++i) expected=point_plus()(make_point(i), expected);
+    expect_eq(expected, sum);
+
+    const int n=4;
+    point in[n], out[n];
+    for (int j=0; j<n; ++j) in[j]=make_point(rank_+j);
+    am::reduce(comm_, in, n, out, point_plus(), ROOT_);
+    if (is_root_) {
+        for (int j=0; j<n; ++j) {
+            point exp=make_point(j);
+            for (int i=1; i<nproc_; ++i) exp=point_plus()(make_point(i+j), exp);
+            expect_eq(exp, out[j]);
+        }
+    }
+}
+
+TEST_F(MpiDatatypesTest, StructGather) {
+    const point mine=make_point(rank_);
+    std::vector<point> all;
+    am::all_gather(comm_, mine, all);
+    ASSERT_EQ(std::size_t(nproc_), all.size());
+    for (int i=0; i<nproc_; ++i) expect_eq(make_point(i), all[i]);
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mpi_hierarchical.hpp>
+
+#include <gtest/gtest.h>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+#include <functional>
+#include <vector>
+
+/* Test node-aware reductions */
+
+namespace am=alps::mpi;
+
+class MpiHierarchicalTest : public ::testing::Test {
+  protected:
+    am::communicator comm_;
+    am::reduction_mode saved_mode_;
+
+  public:
+    MpiHierarchicalTest() : comm_(), saved_mode_(am::get_reduction_mode()) {
+        // take the two-level path even on a single node
+        am::set_reduction_mode(am::node_reduction);
+    }
+
+    ~MpiHierarchicalTest() { am::set_reduction_mode(saved_mode_); }
+
+    // Data of this process: element `i` is `rank+i`
+    std::vector<long> local_data(std::size_t n) const {
+        std::vector<long> data(n);
+        for (std::size_t i=0; i<n; ++i) data[i]=comm_.rank()+i;
+        return data;
+    }
+
+    // Sum of `local_data()` over all processes
+    std::vector<long> expected_sum(std::size_t n) const {
+        const long np=comm_.size();
+        std::vector<long> sum(n);
+        for (std::size_t i=0; i<n; ++i) sum[i]=np*(np-1)/2+np*long(i);
+        return sum;
+    }
+};
+
+TEST_F(MpiHierarchicalTest, Topology) {
+    const am::node_topology& topo=am::node_topology::of(comm_);
+    EXPECT_EQ(&topo, &am::node_topology::of(comm_)) << "Topology is not cached";
+    EXPECT_EQ(comm_.size(), topo.size());
+    EXPECT_EQ(comm_.rank(), topo.rank());
+    EXPECT_LE(1, topo.num_nodes());
+    EXPECT_EQ(topo.is_leader(), topo.node_rank_of(comm_.rank())==0);
+    EXPECT_TRUE(comm_.rank()!=0 || topo.is_leader());
+    EXPECT_EQ(0, topo.node_of(0));
+    if (topo.is_leader()) {
+        EXPECT_EQ(topo.num_nodes(), topo.leaders().size());
+        EXPECT_EQ(topo.node_of(comm_.rank()), topo.leaders().rank());
+    }
+}
+
+TEST_F(MpiHierarchicalTest, Reduce) {
+    const std::size_t n=7;
+    const std::vector<long> expected=expected_sum(n);
+    for (int root=0; root<comm_.size(); ++root) {
+        const std::vector<long> data=local_data(n);
+        std::vector<long> result(n, -1);
+        am::node_aware_reduce(comm_, &data[0], n, &result[0], std::plus<long>(), root);
+        if (comm_.rank()==root) {
+            EXPECT_EQ(expected, result) << "root=" << root;
+        } else {
+            EXPECT_EQ(std::vector<long>(n, -1), result) << "root=" << root;
+        }
+    }
+}
+
+TEST_F(MpiHierarchicalTest, ReduceSeveralNodes) {
+    // pairs of processes as "nodes"
+    const am::node_topology topo(comm_, comm_.rank()/2);
+    EXPECT_EQ((comm_.size()+1)/2, topo.num_nodes());
+
+    const std::size_t n=6;
+    const std::vector<long> expected=expected_sum(n);
+    for (int root=0; root<comm_.size(); ++root) {
+        const std::vector<long> data=local_data(n);
+        std::vector<long> result(n, -1);
+        am::node_aware_reduce(&data[0], &result[0], n, MPI_LONG, MPI_SUM, root, topo);
+        if (comm_.rank()==root) {
+            EXPECT_EQ(expected, result) << "root=" << root;
+        }
+
+        std::vector<long> all(n, -1);
+        am::node_aware_all_reduce(&data[0], &all[0], n, MPI_LONG, MPI_SUM, topo);
+        EXPECT_EQ(expected, all);
+    }
+}
+
+TEST_F(MpiHierarchicalTest, ReduceInPlace) {
+    const std::size_t n=5;
+    const int root=comm_.size()-1;
+    std::vector<long> data=local_data(n);
+    am::node_aware_reduce(comm_, &data[0], n, &data[0], std::plus<long>(), root);
+    EXPECT_EQ(comm_.rank()==root ? expected_sum(n) : local_data(n), data);
+}
+
+TEST_F(MpiHierarchicalTest, AllReduce) {
+    const std::size_t n=3;
+    const std::vector<long> data=local_data(n);
+    std::vector<long> result(n);
+    am::node_aware_all_reduce(comm_, &data[0], n, &result[0], std::plus<long>());
+    EXPECT_EQ(expected_sum(n), result);
+
+    std::vector<long> inplace=local_data(n);
+    am::node_aware_all_reduce(comm_, &inplace[0], n, &inplace[0], std::plus<long>());
+    EXPECT_EQ(expected_sum(n), inplace);
+}
+
+TEST_F(MpiHierarchicalTest, Flat) {
+    am::set_reduction_mode(am::flat_reduction);
+    EXPECT_FALSE(am::use_node_reduction(comm_));
+    const std::size_t n=4;
+    const std::vector<long> data=local_data(n);
+    std::vector<long> result(n);
+    am::node_aware_all_reduce(comm_, &data[0], n, &result[0], std::plus<long>());
+    EXPECT_EQ(expected_sum(n), result);
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv, false); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
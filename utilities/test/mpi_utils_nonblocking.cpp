@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mpi_nonblocking.hpp>
+
+#include <gtest/gtest.h>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+/* Test nonblocking MPI collectives */
+
+namespace am=alps::mpi;
+
+class MpiNonblockingTest : public ::testing::Test {
+  protected:
+    static const int ROOT_=0;
+    am::communicator comm_;
+    int rank_;
+    int nproc_;
+    bool is_root_;
+
+  public:
+    MpiNonblockingTest() : comm_(),
+                           rank_(comm_.rank()),
+                           nproc_(comm_.size()),
+                           is_root_(ROOT_==rank_)
+    {}
+
+    // make the number a bit more interesting than 0...nproc
+    static int mangle(int i) {
+        return 7*i+23;
+    }
+};
+
+TEST_F(MpiNonblockingTest, Request) {
+    am::request req;
+    EXPECT_FALSE(req.active());
+    EXPECT_TRUE(req.test());
+    req.wait();
+
+    std::vector<am::request> reqs;
+    am::wait_all(reqs);
+    reqs.resize(3);
+    am::wait_all(reqs);
+}
+
+TEST_F(MpiNonblockingTest, Broadcast) {
+    const std::size_t n=100;
+    std::vector<double> root_data(n), data(n);
+    std::vector<int> ints(n);
+    std::vector<bool> expected_flags(n);
+    bool flags[n];
+    std::vector< std::complex<double> > cdata(n);
+    for (std::size_t i=0; i<n; ++i) {
+        root_data[i]=alps::testing::datapoint<double>::get(int(i));
+        expected_flags[i]=(i%3==0);
+        flags[i]=is_root_ ? expected_flags[i] : !expected_flags[i];
+        if (is_root_) {
+            data[i]=root_data[i];
+            ints[i]=mangle(i);
+            cdata[i]=std::complex<double>(i,-1.*i);
+        }
+    }
+    int scalar=is_root_ ? mangle(-1) : 0;
+
+    std::vector<am::request> reqs;
+    reqs.push_back(am::ibroadcast(comm_, &data[0], n, ROOT_));
+    reqs.push_back(am::ibroadcast(comm_, &ints[0], n, ROOT_));
+    reqs.push_back(am::ibroadcast(comm_, flags, n, ROOT_));
+    reqs.push_back(am::ibroadcast(comm_, &cdata[0], n, ROOT_));
+    reqs.push_back(am::ibroadcast(comm_, scalar, ROOT_));
+    am::wait_all(reqs);
+
+    for (std::size_t i=0; i<reqs.size(); ++i) EXPECT_FALSE(reqs[i].active());
+    EXPECT_EQ(root_data, data);
+    EXPECT_EQ(mangle(-1), scalar);
+    for (std::size_t i=0; i<n; ++i) {
+        ASSERT_EQ(mangle(i), ints[i]);
+        ASSERT_EQ(bool(expected_flags[i]), flags[i]);
+        ASSERT_EQ(std::complex<double>(i,-1.*i), cdata[i]);
+    }
+}
+
+TEST_F(MpiNonblockingTest, Reduce) {
+    const int n=5;
+    long in[n], out[n], root_out[n];
+    long expected[n];
+    for (int j=0; j<n; ++j) {
+        in[j]=mangle(rank_)*(j+1);
+        expected[j]=0;
+        for (int i=0; i<nproc_; ++i) expected[j]+=mangle(i)*(j+1);
+        root_out[j]=-1;
+    }
+    const double drank=rank_;
+    double dmax;
+    am::request r1=am::iall_reduce(comm_, in, n, out, std::plus<long>());
+    am::request r2=am::ireduce(comm_, in, n, root_out, std::plus<long>(), ROOT_);
+    am::request r3=am::iall_reduce(comm_, drank, dmax, am::maximum<double>());
+
+    while (!r1.test()) {}
+    EXPECT_FALSE(r1.active());
+    r2.wait();
+    r3.wait();
+
+    EXPECT_EQ(nproc_-1, dmax);
+    for (int j=0; j<n; ++j) {
+        EXPECT_EQ(expected[j], out[j]);
+        EXPECT_EQ(is_root_ ? expected[j] : -1, root_out[j]);
+    }
+
+    EXPECT_THROW(am::iall_reduce(comm_, in, 0, out, std::plus<long>()), std::invalid_argument);
+    EXPECT_THROW(am::ireduce(comm_, in, n, in, std::plus<long>(), ROOT_), std::invalid_argument);
+}
+
+TEST_F(MpiNonblockingTest, Gather) {
+    const int my_value=mangle(rank_);
+    std::vector<int> all;
+    am::request req=am::iall_gather(comm_, my_value, all);
+    req.wait();
+    ASSERT_EQ(std::size_t(nproc_), all.size());
+    for (int i=0; i<nproc_; ++i) EXPECT_EQ(mangle(i), all[i]);
+
+    // process i contributes i+1 values
+    std::vector<double> mine(rank_+1, double(rank_));
+    std::vector<int> counts;
+    if (is_root_) {
+        for (int i=0; i<nproc_; ++i) counts.push_back(i+1);
+    }
+    std::vector<double> gathered;
+    {
+        // the destructor completes the operation
+        am::request greq=am::igatherv(comm_, &mine[0], mine.size(), gathered, counts, ROOT_);
+    }
+    if (is_root_) {
+        ASSERT_EQ(std::size_t(nproc_*(nproc_+1)/2), gathered.size());
+        std::size_t k=0;
+        for (int i=0; i<nproc_; ++i) {
+            for (int j=0; j<=i; ++j, ++k) EXPECT_EQ(double(i), gathered[k]);
+        }
+    } else {
+        EXPECT_TRUE(gathered.empty());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
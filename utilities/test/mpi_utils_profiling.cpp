@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mpi_profiling.hpp>
+
+#include <gtest/gtest.h>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+/* Test combining profiling data of MPI processes */
+
+namespace ap=alps::profiling;
+
+TEST(MpiProfilingTest, Collect) {
+    alps::mpi::communicator comm;
+    const int rank=comm.rank();
+    const int nproc=comm.size();
+
+    for (int root=0; root<nproc; ++root) {
+        ap::reset();
+        ap::enable(true);
+        // process i times i+1 intervals and counts i
+        for (int i=0; i<=rank; ++i) {
+            ap::scoped_timer timer("work");
+        }
+        ap::count("rank", rank);
+        if (rank==root) ap::count("root_only");
+        ap::disable();
+
+        const ap::report rep=ap::collect(comm, root);
+        if (rank==root) {
+            EXPECT_EQ(std::size_t(nproc*(nproc+1)/2), rep.timers.find("work")->second.count);
+            const ap::statistics& counted=rep.counters.find("rank")->second;
+            EXPECT_EQ(std::size_t(nproc), counted.count);
+            EXPECT_EQ(nproc*(nproc-1)/2., counted.total);
+            EXPECT_EQ(0., counted.min);
+            EXPECT_EQ(nproc-1., counted.max);
+            EXPECT_EQ(1u, rep.counters.find("root_only")->second.count);
+
+            ASSERT_EQ(std::size_t(nproc*(nproc+1)/2), rep.events.size());
+            std::vector<int> nevents(nproc);
+            for (std::size_t i=0; i<rep.events.size(); ++i) ++nevents.at(rep.events[i].process);
+            for (int i=0; i<nproc; ++i) EXPECT_EQ(i+1, nevents[i]) << "process " << i;
+        } else {
+            EXPECT_EQ(std::size_t(rank+1), rep.timers.find("work")->second.count);
+            EXPECT_EQ(0u, rep.counters.count("root_only"));
+        }
+    }
+    ap::reset();
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
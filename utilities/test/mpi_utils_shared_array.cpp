@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mpi_shared_array.hpp>
+
+#include <gtest/gtest.h>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+/* Test read-only arrays in node-shared memory */
+
+namespace am=alps::mpi;
+
+namespace {
+    // Fills the array with a sequence of numbers
+    struct sequence_filler {
+        double start_;
+        explicit sequence_filler(double start) : start_(start) {}
+        void operator()(double* data, std::size_t size) const {
+            for (std::size_t i=0; i<size; ++i) data[i]=start_+i;
+        }
+    };
+}
+
+class MpiSharedArrayTest : public ::testing::Test {
+  protected:
+    am::communicator comm_;
+    int rank_;
+    int nproc_;
+
+  public:
+    MpiSharedArrayTest() : comm_(),
+                           rank_(comm_.rank()),
+                           nproc_(comm_.size())
+    {}
+};
+
+TEST_F(MpiSharedArrayTest, Fill) {
+    const std::size_t n=1000;
+    am::node_shared_array<double> arr(comm_, n);
+    ASSERT_EQ(n, arr.size());
+    if (rank_==0) {
+        EXPECT_TRUE(arr.is_node_leader());
+    }
+
+    arr.fill(sequence_filler(0.5));
+    for (std::size_t i=0; i<n; ++i) {
+        ASSERT_EQ(0.5+i, arr[i]) << "i=" << i;
+    }
+
+    // a copy refers to the same memory
+    am::node_shared_array<double> copy(arr);
+    EXPECT_EQ(arr.data(), copy.data());
+    arr.fill(sequence_filler(-1.));
+    EXPECT_EQ(-1., copy[0]);
+    EXPECT_EQ(n-2., *(copy.end()-1));
+}
+
+TEST_F(MpiSharedArrayTest, Broadcast) {
+    // test each root (the root leads its node)
+    for (int root=0; root<nproc_; ++root) {
+        std::vector<int> vals;
+        if (rank_==root) {
+            for (int i=0; i<1001; ++i) vals.push_back(7*i+root);
+        }
+        am::node_shared_array<int> arr=am::broadcast_shared(comm_, vals, root);
+        if (rank_==root) {
+            EXPECT_TRUE(arr.is_node_leader());
+        }
+        ASSERT_EQ(1001u, arr.size());
+        for (int i=0; i<1001; ++i) {
+            ASSERT_EQ(7*i+root, arr[i]) << "root=" << root << " i=" << i;
+        }
+    }
+}
+
+TEST_F(MpiSharedArrayTest, Empty) {
+    std::vector<long> vals;
+    am::node_shared_array<long> arr=am::broadcast_shared(comm_, vals, 0);
+    EXPECT_TRUE(arr.empty());
+    EXPECT_EQ(arr.begin(), arr.end());
+}
+
+TEST_F(MpiSharedArrayTest, NodeCommunicator) {
+    am::node_shared_array<double> arr(comm_, 1);
+    const am::communicator& node=arr.node_communicator();
+    const int node_size=node.size();
+    EXPECT_GE(nproc_, node_size);
+    // each node has exactly one leader
+    const int nleaders=am::all_reduce(comm_, int(arr.is_node_leader()), std::plus<int>());
+    const int nodes_sizes=am::all_reduce(comm_, (arr.is_node_leader() ? node_size : 0), std::plus<int>());
+    EXPECT_LE(1, nleaders);
+    EXPECT_EQ(nproc_, nodes_sizes);
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
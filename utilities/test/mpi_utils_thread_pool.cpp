@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/utilities/mpi_thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include "./test_utils.hpp"
+#include <alps/utilities/gtest_par_xml_output.hpp>
+
+/* Test sizing the thread pool in MPI runs */
+
+namespace at=alps::threading;
+
+TEST(MpiThreadPoolTest, ProcessesOnNode) {
+    alps::mpi::communicator comm;
+    const int nlocal=at::processes_on_node(comm);
+    EXPECT_LE(1, nlocal);
+    EXPECT_GE(comm.size(), nlocal);
+}
+
+TEST(MpiThreadPoolTest, Configure) {
+    alps::mpi::communicator comm;
+    EXPECT_EQ(2u, at::configure(comm, 2));
+    EXPECT_EQ(2u, at::num_threads());
+
+    const std::size_t n=at::configure(comm);
+    EXPECT_LE(1u, n);
+    if (at::environment_threads()==0) {
+        EXPECT_GE(at::hardware_threads(), n*at::processes_on_node(comm));
+    }
+}
+
+TEST(MpiThreadPoolTest, ThreadLevel) {
+    // the environment of this test requests MPI_THREAD_FUNNELED
+    const int level=alps::mpi::environment::thread_level();
+    EXPECT_LE(MPI_THREAD_FUNNELED, level);
+    EXPECT_EQ(level==MPI_THREAD_MULTIPLE, at::tasks_may_call_mpi());
+}
+
+int main(int argc, char** argv)
+{
+    alps::mpi::environment env(argc, argv, MPI_THREAD_FUNNELED); // initializes MPI environment
+    alps::gtest_par_xml_output tweak;
+    tweak(alps::mpi::communicator().rank(), argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
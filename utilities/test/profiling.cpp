@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file profiling.cpp
+
+    @brief Tests scoped timers and counters
+*/
+
+#include <alps/utilities/profiling.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace ap=alps::profiling;
+
+class ProfilingTest : public ::testing::Test {
+  public:
+    ProfilingTest() { ap::reset(); }
+    ~ProfilingTest() { ap::disable(); ap::reset(); }
+};
+
+namespace {
+    void timed_work(int n) {
+        ap::scoped_timer timer("work");
+        for (int i=0; i<n; ++i) ap::count("items");
+    }
+}
+
+TEST_F(ProfilingTest, Disabled) {
+    ap::disable();
+    EXPECT_FALSE(ap::is_enabled());
+    timed_work(3);
+    EXPECT_TRUE(ap::collect().empty());
+}
+
+TEST_F(ProfilingTest, TimersAndCounters) {
+    ap::enable();
+    EXPECT_TRUE(ap::is_enabled());
+    EXPECT_FALSE(ap::is_tracing());
+    timed_work(3);
+    timed_work(4);
+    ap::count("weight", 0.5);
+    ap::count("weight", 2.5);
+
+    const ap::report rep=ap::collect();
+    ASSERT_EQ(1u, rep.timers.count("work"));
+    const ap::statistics& work=rep.timers.find("work")->second;
+    EXPECT_EQ(2u, work.count);
+    EXPECT_LE(0., work.min);
+    EXPECT_LE(work.min, work.max);
+    EXPECT_NEAR(work.total, work.min+work.max, 1E-12);
+
+    ASSERT_EQ(2u, rep.counters.size());
+    EXPECT_EQ(7u, rep.counters.find("items")->second.count);
+    EXPECT_EQ(7., rep.counters.find("items")->second.total);
+    EXPECT_EQ(3., rep.counters.find("weight")->second.total);
+    EXPECT_EQ(0.5, rep.counters.find("weight")->second.min);
+    EXPECT_EQ(2.5, rep.counters.find("weight")->second.max);
+    EXPECT_TRUE(rep.events.empty());
+
+    ap::reset();
+    EXPECT_TRUE(ap::collect().empty());
+}
+
+TEST_F(ProfilingTest, Threads) {
+    ap::enable(true);
+    const int nthreads=4;
+    std::vector<std::thread> threads;
+    for (int i=0; i<nthreads; ++i) threads.push_back(std::thread(timed_work, 10));
+    for (int i=0; i<nthreads; ++i) threads[i].join();
+    timed_work(1);
+
+    const ap::report rep=ap::collect();
+    EXPECT_EQ(nthreads+1u, rep.timers.find("work")->second.count);
+    EXPECT_EQ(10.*nthreads+1, rep.counters.find("items")->second.total);
+    ASSERT_EQ(nthreads+1u, rep.events.size());
+    for (std::size_t i=0; i<rep.events.size(); ++i) {
+        EXPECT_EQ("work", rep.events[i].name);
+        EXPECT_LE(0., rep.events[i].duration);
+    }
+}
+
+TEST_F(ProfilingTest, TraceLimit) {
+    ap::enable(true, 2);
+    timed_work(0);
+    timed_work(0);
+    timed_work(0);
+    const ap::report rep=ap::collect();
+    EXPECT_EQ(3u, rep.timers.find("work")->second.count);
+    EXPECT_EQ(2u, rep.events.size());
+}
+
+TEST_F(ProfilingTest, Output) {
+    ap::enable(true);
+    { ap::scoped_timer timer("quoted \"name\""); }
+    ap::count("items", 5);
+    const ap::report rep=ap::collect();
+
+    std::ostringstream trace;
+    rep.write_chrome_trace(trace);
+    const std::string json=trace.str();
+    EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"quoted \\\"name\\\"\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"items\",\"ph\":\"C\""));
+    EXPECT_NE(std::string::npos, json.find("\"args\":{\"total\":5}"));
+
+    std::ostringstream table;
+    rep.print(table);
+    EXPECT_NE(std::string::npos, table.str().find("quoted \"name\""));
+    EXPECT_NE(std::string::npos, table.str().find("items"));
+}
+
+TEST_F(ProfilingTest, PackUnpack) {
+    ap::enable(true);
+    timed_work(2);
+    ap::count("weight", 0.25);
+    const ap::report rep=ap::collect();
+
+    std::string buf;
+    ap::detail::pack(rep, buf);
+    const ap::report copy=ap::detail::unpack(buf.data(), buf.size());
+    ASSERT_EQ(rep.timers.size(), copy.timers.size());
+    EXPECT_EQ(rep.timers.find("work")->second.total, copy.timers.find("work")->second.total);
+    EXPECT_EQ(rep.counters.find("weight")->second.max, copy.counters.find("weight")->second.max);
+    ASSERT_EQ(1u, copy.events.size());
+    EXPECT_EQ(rep.events[0].begin, copy.events[0].begin);
+
+    EXPECT_THROW(ap::detail::unpack(buf.data(), buf.size()-1), std::invalid_argument);
+
+    ap::report merged=rep;
+    merged.merge(copy);
+    EXPECT_EQ(4., merged.counters.find("items")->second.total);
+    EXPECT_EQ(2u, merged.events.size());
+}
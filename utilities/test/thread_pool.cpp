@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file thread_pool.cpp
+
+    @brief Tests the shared thread pool
+*/
+
+#include <alps/utilities/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace at=alps::threading;
+
+class ThreadPoolTest : public ::testing::TestWithParam<std::size_t> {
+  public:
+    at::thread_pool pool;
+    ThreadPoolTest() : pool(GetParam()) { }
+};
+
+TEST_P(ThreadPoolTest, Size) {
+    EXPECT_EQ(std::max<std::size_t>(GetParam(), 1), pool.size());
+}
+
+TEST_P(ThreadPoolTest, ParallelFor) {
+    const int n=1001;
+    std::vector<int> out(n, -1);
+    at::parallel_for(0, n, [&out](int i) { out[i]=2*i; }, 0, pool);
+    for (int i=0; i<n; ++i) ASSERT_EQ(2*i, out[i]) << "i=" << i;
+
+    // explicit grain, which does not divide the range
+    std::vector<std::atomic<int> > visits(n);
+    for (int i=0; i<n; ++i) visits[i]=0;
+    at::parallel_for(std::size_t(0), std::size_t(n), [&visits](std::size_t i) { ++visits[i]; }, 7, pool);
+    for (int i=0; i<n; ++i) ASSERT_EQ(1, visits[i].load()) << "i=" << i;
+
+    at::parallel_for(5, 5, [](int) { FAIL(); }, 0, pool);
+}
+
+TEST_P(ThreadPoolTest, Threads) {
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    at::parallel_for(0, 64, [&](int) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+        }, 1, pool);
+    EXPECT_LE(ids.size(), pool.size());
+    if (pool.size()>1) {
+        EXPECT_LT(1u, ids.size());
+    }
+}
+
+TEST_P(ThreadPoolTest, NestedTasks) {
+    std::atomic<long> sum(0);
+    at::task_group outer(pool);
+    for (int i=0; i<8; ++i) {
+        outer.run([&sum, this]() {
+                at::task_group inner(pool);
+                for (int j=1; j<=100; ++j) inner.run([&sum, j]() { sum+=j; });
+                inner.wait();
+            });
+    }
+    outer.wait();
+    EXPECT_EQ(8*5050, sum.load());
+}
+
+TEST_P(ThreadPoolTest, Exceptions) {
+    at::task_group tasks(pool);
+    std::atomic<int> done(0);
+    for (int i=0; i<10; ++i) {
+        tasks.run([&done, i]() {
+                ++done;
+                if (i==3) throw std::runtime_error("task failed");
+            });
+    }
+    EXPECT_THROW(tasks.wait(), std::runtime_error);
+    EXPECT_EQ(10, done.load());
+    EXPECT_NO_THROW(tasks.wait()); // the error is reported once
+
+    EXPECT_THROW(at::parallel_for(0, 100, [](int i) { if (i==99) throw std::logic_error("last"); }, 10, pool),
+                 std::logic_error);
+    EXPECT_THROW(at::parallel_for(0, 100, [](int i) { if (i==0) throw std::logic_error("first"); }, 10, pool),
+                 std::logic_error);
+}
+
+INSTANTIATE_TEST_CASE_P(PoolSizes, ThreadPoolTest, ::testing::Values(0u, 1u, 2u, 4u));
+
+TEST(ThreadPoolDefaultTest, SetNumThreads) {
+    at::set_num_threads(3);
+    EXPECT_EQ(3u, at::num_threads());
+    std::vector<double> v(100);
+    at::parallel_for(0, 100, [&v](int i) { v[i]=i; });
+    EXPECT_EQ(4950., std::accumulate(v.begin(), v.end(), 0.));
+
+    at::set_num_threads(0);
+    const std::size_t env=at::environment_threads();
+    EXPECT_EQ(env>0 ? env : at::hardware_threads(), at::num_threads());
+}
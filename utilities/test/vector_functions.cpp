@@ -162,3 +162,94 @@ TYPED_TEST(VectorFunctionsTest, testMergeToLarger) {
     ASSERT_EQ(5,vec1.size());
     EXPECT_EQ(res, vec1);
 }
+
+TYPED_TEST(VectorFunctionsTest, testAddSquare) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::add_square;
+    value_type vec1=gen_data<value_type>(2.25);
+    const value_type vec2=gen_data<value_type>(1.50);
+    value_type res=gen_data<value_type>(2.25+1.50*1.50);
+    value_type& summed=add_square(vec1,vec2);
+    EXPECT_EQ(&summed, &vec1);
+    ASSERT_EQ(res.size(),vec1.size());
+    EXPECT_EQ(res, vec1);
+}
+
+
+// GoogleTest fixture, parametrized over element types with vectorized in-place operations
+template <typename T>
+struct VectorInPlaceTest : public ::testing::Test
+{
+    typedef T element_type;
+    typedef std::vector<T> value_type;
+
+    // enough elements to have a vectorized body and a remainder
+    static const std::size_t SIZE=37;
+
+    static value_type make(double start) {
+        value_type vec(SIZE);
+        for (std::size_t i=0; i<SIZE; ++i) vec[i]=element_type(start+i);
+        return vec;
+    }
+};
+
+typedef ::testing::Types< float, double, std::complex<float>, std::complex<double> > simd_types;
+TYPED_TEST_CASE(VectorInPlaceTest, simd_types);
+
+TYPED_TEST(VectorInPlaceTest, testOperators) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::operator+=;
+    using alps::numeric::operator-=;
+    using alps::numeric::operator*=;
+    using alps::numeric::operator/=;
+    const value_type vec1=TestFixture::make(0.5);
+    const value_type vec2=TestFixture::make(2);
+    value_type sum=vec1, diff=vec1, prod=vec1, quot=vec1;
+    sum += vec2;
+    diff -= vec2;
+    prod *= vec2;
+    quot /= vec2;
+    for (std::size_t i=0; i<vec1.size(); ++i) {
+        EXPECT_EQ(vec1[i]+vec2[i], sum[i]);
+        EXPECT_EQ(vec1[i]-vec2[i], diff[i]);
+        EXPECT_EQ(vec1[i]*vec2[i], prod[i]);
+        EXPECT_EQ(vec1[i]/vec2[i], quot[i]);
+    }
+}
+
+TYPED_TEST(VectorInPlaceTest, testScalar) {
+    typedef typename TestFixture::value_type value_type;
+    typedef typename TestFixture::element_type element_type;
+    using alps::numeric::operator*=;
+    using alps::numeric::operator/=;
+    const value_type vec=TestFixture::make(0.5);
+    value_type scaled=vec, divided=vec;
+    scaled *= element_type(4);
+    divided /= element_type(4);
+    for (std::size_t i=0; i<vec.size(); ++i) {
+        EXPECT_EQ(element_type(4)*vec[i], scaled[i]);
+        EXPECT_EQ(vec[i]/element_type(4), divided[i]);
+    }
+}
+
+TYPED_TEST(VectorInPlaceTest, testFused) {
+    typedef typename TestFixture::value_type value_type;
+    typedef typename TestFixture::element_type element_type;
+    using alps::numeric::axpy;
+    using alps::numeric::add_square;
+    const value_type x=TestFixture::make(0.5);
+    const value_type y0=TestFixture::make(-3);
+    value_type y=y0, sum2=y0;
+    value_type& y_ref=axpy(y, element_type(0.25), x);
+    EXPECT_EQ(&y_ref, &y);
+    add_square(sum2, x);
+    for (std::size_t i=0; i<x.size(); ++i) {
+        EXPECT_EQ(y0[i]+element_type(0.25)*x[i], y[i]);
+        EXPECT_EQ(y0[i]+x[i]*x[i], sum2[i]);
+    }
+
+    value_type empty;
+    EXPECT_TRUE(add_square(empty, value_type()).empty());
+    EXPECT_THROW(add_square(y, empty), std::runtime_error);
+    EXPECT_THROW(axpy(y, element_type(1), empty), std::runtime_error);
+}